@@ -1,87 +1,119 @@
 #include "backlight.h"
+#include <algorithm>
+#include <array>
 #include <esp_log.h>
+#include <esp_attr.h>
 #include <driver/ledc.h>
+#include <freertos/semphr.h>
+#include <freertos/timers.h>
 
 #define TAG "Backlight"
 #define BACKLIGHT_LEDC_CHANNEL LEDC_CHANNEL_0
 #define BACKLIGHT_LEDC_TIMER LEDC_TIMER_0
+#define BACKLIGHT_LEDC_RESOLUTION LEDC_TIMER_13_BIT
 
-Backlight::Backlight() : brightness_(128), target_brightness_(128)
+static constexpr uint32_t kMaxDuty = (1u << BACKLIGHT_LEDC_RESOLUTION) - 1;
+
+// A fade is split into at most this many linear hardware ramps, each lasting at least kMinSegmentMs
+static constexpr int kMaxFadeSegments = 8;
+static constexpr int kMinSegmentMs = 40;
+
+// CIE 1931 lightness to luminance: level 0..255 is treated as perceived lightness L* 0..100
+static constexpr uint16_t PerceivedLevelToDuty(int level)
 {
-    // Create transition timer
-    esp_timer_create_args_t timer_args = {
-        .callback = [](void *arg)
-        {
-            static_cast<Backlight *>(arg)->OnTransitionTimer();
-        },
-        .arg = this,
-        .dispatch_method = ESP_TIMER_TASK,
-        .name = "backlight_transition",
-        .skip_unhandled_events = false,
-    };
-    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &transition_timer_));
+    double lightness = level * 100.0 / 255.0;
+    double luminance = lightness <= 8.0 ? lightness / 903.3
+                                        : ((lightness + 16.0) / 116.0) * ((lightness + 16.0) / 116.0) * ((lightness + 16.0) / 116.0);
+    uint32_t duty = static_cast<uint32_t>(luminance * kMaxDuty + 0.5);
+    // Keep every non-zero level visibly on
+    return (level > 0 && duty == 0) ? 1 : duty;
 }
 
-Backlight::~Backlight()
+static constexpr std::array<uint16_t, 256> MakeBrightnessTable()
 {
-    if (transition_timer_)
+    std::array<uint16_t, 256> table = {};
+    for (int level = 0; level < 256; level++)
     {
-        esp_timer_stop(transition_timer_);
-        esp_timer_delete(transition_timer_);
+        table[level] = PerceivedLevelToDuty(level);
     }
+    return table;
 }
 
-void Backlight::RestoreBrightness()
+static constexpr std::array<uint16_t, 256> kBrightnessToDuty = MakeBrightnessTable();
+static_assert(kBrightnessToDuty[0] == 0 && kBrightnessToDuty[255] == kMaxDuty, "table must span the full duty range");
+
+// Level whose duty is closest to the given one from below, used to pick up an interrupted fade
+static uint8_t DutyToLevel(uint32_t duty)
 {
-    // Default brightness
-    SetBrightness(204); // 80% brightness
+    int low = 0;
+    int high = 255;
+    while (low < high)
+    {
+        int mid = (low + high + 1) / 2;
+        if (kBrightnessToDuty[mid] <= duty)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+    return low;
 }
 
-void Backlight::SetBrightness(uint8_t brightness, bool permanent)
-{
-    target_brightness_ = brightness;
+// Serialises fade starts between callers and the timer task that queues the next ramp
+static SemaphoreHandle_t fade_mutex = nullptr;
 
-    if (brightness_ == target_brightness_)
+static IRAM_ATTR bool backlight_fade_cb(const ledc_cb_param_t *param, void *user_arg)
+{
+    if (param->event != LEDC_FADE_END_EVT)
     {
-        return;
+        return false;
     }
+    return static_cast<PwmBacklight *>(user_arg)->OnFadeEnd(param->duty);
+}
 
-    // Start transition timer
-    step_ = (brightness_ < target_brightness_) ? 2 : -2;
-    esp_timer_start_periodic(transition_timer_, 10000); // 10ms intervals
+Backlight::Backlight() : brightness_(128), target_brightness_(128)
+{
 }
 
-void Backlight::OnTransitionTimer()
+Backlight::~Backlight()
 {
-    if (step_ > 0 && brightness_ >= target_brightness_)
-    {
-        brightness_ = target_brightness_;
-        esp_timer_stop(transition_timer_);
-    }
-    else if (step_ < 0 && brightness_ <= target_brightness_)
-    {
-        brightness_ = target_brightness_;
-        esp_timer_stop(transition_timer_);
-    }
-    else
+}
+
+void Backlight::RestoreBrightness()
+{
+    // Default brightness
+    SetBrightness(204); // 80% brightness
+}
+
+void Backlight::SetBrightness(uint8_t brightness, [[maybe_unused]] bool permanent, int fade_ms)
+{
+    if (brightness == target_brightness_)
     {
-        brightness_ += step_;
+        return;
     }
-
-    SetBrightnessImpl(brightness_);
+    target_brightness_ = brightness;
+    SetBrightnessImpl(brightness, fade_ms);
 }
 
 PwmBacklight::PwmBacklight(gpio_num_t pin, bool output_invert)
     : pin_(pin), output_invert_(output_invert)
 {
+    if (fade_mutex == nullptr)
+    {
+        fade_mutex = xSemaphoreCreateMutex();
+    }
 
     // Configure LEDC
     ledc_timer_config_t timer_config = {
         .speed_mode = LEDC_LOW_SPEED_MODE,
-        .duty_resolution = LEDC_TIMER_8_BIT,
+        .duty_resolution = BACKLIGHT_LEDC_RESOLUTION,
         .timer_num = BACKLIGHT_LEDC_TIMER,
         .freq_hz = 1000,
-        .clk_cfg = LEDC_AUTO_CLK,
+        // XTAL keeps the PWM frequency fixed when DFS changes the APB clock
+        .clk_cfg = LEDC_USE_XTAL_CLK,
     };
     ESP_ERROR_CHECK(ledc_timer_config(&timer_config));
 
@@ -97,18 +129,130 @@ PwmBacklight::PwmBacklight(gpio_num_t pin, bool output_invert)
             .output_invert = static_cast<unsigned int>(output_invert_)}};
     ESP_ERROR_CHECK(ledc_channel_config(&channel_config));
 
-    ESP_LOGI(TAG, "PWM backlight initialized on pin %d", pin_);
+    // Fade end interrupt, another LEDC user may have installed the fade service already
+    esp_err_t ret = ledc_fade_func_install(0);
+    if (ret != ESP_ERR_INVALID_STATE)
+    {
+        ESP_ERROR_CHECK(ret);
+        owns_fade_service_ = true;
+    }
+    ledc_cbs_t callbacks = {
+        .fade_cb = backlight_fade_cb,
+    };
+    ESP_ERROR_CHECK(ledc_cb_register(LEDC_LOW_SPEED_MODE, BACKLIGHT_LEDC_CHANNEL, &callbacks, this));
+
+    ESP_LOGI(TAG, "PWM backlight initialized on pin %d, %d-bit duty", pin_, BACKLIGHT_LEDC_RESOLUTION);
 }
 
 PwmBacklight::~PwmBacklight()
 {
+    xSemaphoreTake(fade_mutex, portMAX_DELAY);
+    portENTER_CRITICAL(&fade_lock_);
+    fade_generation_++;
+    bool was_fading = fading_;
+    fading_ = false;
+    portEXIT_CRITICAL(&fade_lock_);
+    if (was_fading)
+    {
+        ledc_fade_stop(LEDC_LOW_SPEED_MODE, BACKLIGHT_LEDC_CHANNEL);
+    }
+    xSemaphoreGive(fade_mutex);
+
+    // Leave a fade service installed by another LEDC user in place
+    if (owns_fade_service_)
+    {
+        ledc_fade_func_uninstall();
+    }
     // Stop LEDC
     ledc_stop(LEDC_LOW_SPEED_MODE, BACKLIGHT_LEDC_CHANNEL, 0);
 }
 
-void PwmBacklight::SetBrightnessImpl(uint8_t brightness)
+void PwmBacklight::SetBrightnessImpl(uint8_t brightness, int fade_ms)
+{
+    xSemaphoreTake(fade_mutex, portMAX_DELAY);
+
+    // Freeze a running fade where it is and continue from there
+    portENTER_CRITICAL(&fade_lock_);
+    bool was_fading = fading_;
+    fading_ = false;
+    fade_generation_++;
+    portEXIT_CRITICAL(&fade_lock_);
+    if (was_fading)
+    {
+        ledc_fade_stop(LEDC_LOW_SPEED_MODE, BACKLIGHT_LEDC_CHANNEL);
+    }
+    uint8_t from = DutyToLevel(ledc_get_duty(LEDC_LOW_SPEED_MODE, BACKLIGHT_LEDC_CHANNEL));
+
+    int distance = brightness > from ? brightness - from : from - brightness;
+    int segments = std::min(std::min(fade_ms / kMinSegmentMs, kMaxFadeSegments), distance);
+    if (segments < 1 || fade_ms <= 0)
+    {
+        ESP_ERROR_CHECK(ledc_set_duty_and_update(LEDC_LOW_SPEED_MODE, BACKLIGHT_LEDC_CHANNEL,
+                                                 kBrightnessToDuty[brightness], 0));
+        brightness_ = brightness;
+        xSemaphoreGive(fade_mutex);
+        return;
+    }
+
+    portENTER_CRITICAL(&fade_lock_);
+    uint32_t generation = fade_generation_;
+    fade_from_ = from;
+    fade_to_ = brightness;
+    fade_segments_ = segments;
+    fade_segment_ = 0;
+    fade_segment_ms_ = fade_ms / segments;
+    fading_ = true;
+    portEXIT_CRITICAL(&fade_lock_);
+    xSemaphoreGive(fade_mutex);
+
+    StartFadeSegment(generation);
+}
+
+void PwmBacklight::StartFadeSegment(uint32_t generation)
+{
+    xSemaphoreTake(fade_mutex, portMAX_DELAY);
+    portENTER_CRITICAL(&fade_lock_);
+    if (generation != fade_generation_ || !fading_)
+    {
+        // Superseded by a newer SetBrightness
+        portEXIT_CRITICAL(&fade_lock_);
+        xSemaphoreGive(fade_mutex);
+        return;
+    }
+    fade_segment_++;
+    int level = fade_from_ + (fade_to_ - fade_from_) * fade_segment_ / fade_segments_;
+    uint32_t duty = kBrightnessToDuty[level];
+    fade_segment_duty_ = duty;
+    int segment_ms = fade_segment_ms_;
+    portEXIT_CRITICAL(&fade_lock_);
+
+    ESP_ERROR_CHECK(ledc_set_fade_time_and_start(LEDC_LOW_SPEED_MODE, BACKLIGHT_LEDC_CHANNEL, duty, segment_ms,
+                                                 LEDC_FADE_NO_WAIT));
+    xSemaphoreGive(fade_mutex);
+}
+
+// LEDC interrupt: queue the next ramp on the timer task, or record that the fade is done
+IRAM_ATTR bool PwmBacklight::OnFadeEnd(uint32_t duty)
 {
-    uint32_t duty = brightness;
-    ESP_ERROR_CHECK(ledc_set_duty(LEDC_LOW_SPEED_MODE, BACKLIGHT_LEDC_CHANNEL, duty));
-    ESP_ERROR_CHECK(ledc_update_duty(LEDC_LOW_SPEED_MODE, BACKLIGHT_LEDC_CHANNEL));
-}
\ No newline at end of file
+    portENTER_CRITICAL_ISR(&fade_lock_);
+    // A ramp cut short by ledc_fade_stop ends somewhere else and must not advance the fade
+    if (!fading_ || duty != fade_segment_duty_)
+    {
+        portEXIT_CRITICAL_ISR(&fade_lock_);
+        return false;
+    }
+    if (fade_segment_ < fade_segments_)
+    {
+        uint32_t generation = fade_generation_;
+        portEXIT_CRITICAL_ISR(&fade_lock_);
+        BaseType_t need_yield = pdFALSE;
+        xTimerPendFunctionCallFromISR([](void *arg, uint32_t generation)
+                                      { static_cast<PwmBacklight *>(arg)->StartFadeSegment(generation); },
+                                      this, generation, &need_yield);
+        return need_yield == pdTRUE;
+    }
+    fading_ = false;
+    brightness_ = fade_to_;
+    portEXIT_CRITICAL_ISR(&fade_lock_);
+    return false;
+}
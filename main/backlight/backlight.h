@@ -2,38 +2,61 @@
 
 #include <cstdint>
 #include <driver/gpio.h>
-#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
 
 class Backlight
 {
 public:
+    // Fade used when the caller does not ask for one
+    static constexpr int kDefaultFadeMs = 300;
+
     Backlight();
     virtual ~Backlight();
 
     void RestoreBrightness();
-    void SetBrightness(uint8_t brightness, bool permanent = false);
+    // Fades from the current level to brightness in fade_ms, 0 switches immediately
+    void SetBrightness(uint8_t brightness, bool permanent = false, int fade_ms = kDefaultFadeMs);
+    // Level reached by the last completed fade
     inline uint8_t brightness() const { return brightness_; }
+    inline uint8_t target_brightness() const { return target_brightness_; }
 
 protected:
-    void OnTransitionTimer();
-    virtual void SetBrightnessImpl(uint8_t brightness) = 0;
+    virtual void SetBrightnessImpl(uint8_t brightness, int fade_ms) = 0;
 
-    esp_timer_handle_t transition_timer_ = nullptr;
-    uint8_t brightness_ = 0;
+    volatile uint8_t brightness_ = 0;
     uint8_t target_brightness_ = 0;
-    uint8_t step_ = 1;
 };
 
+// Drives the backlight with the LEDC fade unit. Levels go through a perceptual lookup table, and a
+// fade is split into a few hardware ramps so the linear duty ramps follow that curve. The CPU only
+// runs when a ramp ends and the next one has to be queued.
 class PwmBacklight : public Backlight
 {
 public:
     PwmBacklight(gpio_num_t pin, bool output_invert = false);
     virtual ~PwmBacklight();
 
+    // Called from the LEDC interrupt when a hardware ramp has finished
+    bool OnFadeEnd(uint32_t duty);
+
 protected:
-    virtual void SetBrightnessImpl(uint8_t brightness) override;
+    virtual void SetBrightnessImpl(uint8_t brightness, int fade_ms) override;
 
 private:
     gpio_num_t pin_;
     bool output_invert_;
-};
\ No newline at end of file
+    bool owns_fade_service_ = false;
+
+    // Fade in progress, guarded by fade_lock_
+    portMUX_TYPE fade_lock_ = portMUX_INITIALIZER_UNLOCKED;
+    uint32_t fade_generation_ = 0;
+    uint8_t fade_from_ = 0;
+    uint8_t fade_to_ = 0;
+    int fade_segments_ = 0;
+    int fade_segment_ = 0;
+    int fade_segment_ms_ = 0;
+    uint32_t fade_segment_duty_ = 0;
+    bool fading_ = false;
+
+    void StartFadeSegment(uint32_t generation);
+};
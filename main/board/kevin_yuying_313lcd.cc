@@ -1,22 +1,32 @@
 #include "board.h"
 #include "display/lcd_display.h"
+#include "display/boot_splash.h"
+#include "display/band_scheduler.h"
+#include "display/framebuffer_dma.h"
+#include "display/panel_scanout.h"
 #include "backlight/backlight.h"
 #include "audio/dummy_audio_codec.h"
 #include "config.h"
+#include "boot_trace.h"
 #include "pin_config.h"
 #include "esp_lcd_gc9503.h"
 
 #include <esp_log.h>
+#include <esp_heap_caps.h>
 #include <esp_lcd_panel_io.h>
 #include <esp_lcd_panel_ops.h>
 #include <esp_lcd_panel_io_additions.h>
 
 #define TAG "Yuying_313lcd"
 
+static_assert(!DISPLAY_MONO_FRAMEBUFFER || DISPLAY_SCANOUT_STAGE, "monochrome frame buffers are tinted by the scan-out stage");
+static_assert(!DISPLAY_STATUS_OVERLAY || DISPLAY_SCANOUT_STAGE, "overlays are composited by the scan-out stage");
+
 class Yuying_313lcd : public Board
 {
 private:
     LcdDisplay *display_;
+    PanelScanout *scanout_ = nullptr;
     Backlight *backlight_;
     DummyAudioCodec *audio_codec_;
 
@@ -37,17 +47,24 @@ private:
             .io_expander = NULL,
         };
         esp_lcd_panel_io_3wire_spi_config_t io_config = GC9503_PANEL_IO_3WIRE_SPI_CONFIG(line_config, 0);
+        auto &trace = BootTrace::GetInstance();
+        trace.Begin(BootPhase::kPanelIo);
         ESP_ERROR_CHECK(esp_lcd_new_panel_io_3wire_spi(&io_config, &panel_io));
+        trace.End(BootPhase::kPanelIo);
 
         ESP_LOGI(TAG, "Install RGB LCD panel driver");
+        const FramebufferProfileConfig &profile = GetFramebufferProfile(DISPLAY_FB_PROFILE);
+        size_t psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+        size_t internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
         esp_lcd_panel_handle_t panel_handle = NULL;
         esp_lcd_rgb_panel_config_t rgb_config = {
             .clk_src = LCD_CLK_SRC_PLL160M,
             .timings = GC9503_376_960_PANEL_60HZ_RGB_TIMING(),
             .data_width = 16, // RGB565 in parallel mode, thus 16bit in width
             .bits_per_pixel = 16,
-            .num_fbs = GC9503V_LCD_RGB_BUFFER_NUMS,
-            .bounce_buffer_size_px = GC9503V_LCD_H_RES * GC9503V_LCD_RGB_BOUNCE_BUFFER_HEIGHT,
+            // With the scan-out stage the frame buffers are its own and it fills the bounce buffers
+            .num_fbs = DISPLAY_SCANOUT_STAGE ? 0 : static_cast<size_t>(profile.num_fbs),
+            .bounce_buffer_size_px = static_cast<size_t>(GC9503V_LCD_H_RES * profile.bounce_buffer_lines),
             .dma_burst_size = 64,
             .hsync_gpio_num = GC9503V_PIN_NUM_HSYNC,
             .vsync_gpio_num = GC9503V_PIN_NUM_VSYNC,
@@ -74,6 +91,7 @@ private:
             },
             .flags = {
                 .fb_in_psram = true, // allocate frame buffer in PSRAM
+                .no_fb = DISPLAY_SCANOUT_STAGE,
             }};
 
         ESP_LOGI(TAG, "Initialize RGB LCD panel");
@@ -91,13 +109,123 @@ private:
             .bits_per_pixel = 16,
             .vendor_config = &vendor_config,
         };
+        trace.Begin(BootPhase::kGc9503InitUpload);
         ESP_ERROR_CHECK(esp_lcd_new_panel_gc9503(panel_io, &panel_config, &panel_handle));
+        trace.End(BootPhase::kGc9503InitUpload);
+        // esp_lcd_panel_init starts scan-out, the bounce callbacks must be in place before it
+        if (DISPLAY_SCANOUT_STAGE)
+        {
+            scanout_ = new PanelScanout(panel_handle, DISPLAY_WIDTH, DISPLAY_HEIGHT, profile.num_fbs,
+                                        DISPLAY_MONO_FRAMEBUFFER);
+            if (DISPLAY_MONO_FRAMEBUFFER)
+            {
+                uint16_t tint[256];
+                PanelScanout::RampPalette(0x0000, DISPLAY_MONO_TINT, tint);
+                scanout_->SetPalette(tint);
+            }
+            ColorLut calibration;
+            if (ColorLut::LoadCalibration(&calibration))
+            {
+                ESP_LOGI(TAG, "Applying the panel's colour calibration");
+                scanout_->SetCalibration(calibration);
+            }
+        }
+        trace.Begin(BootPhase::kRgbPanelInit);
         ESP_ERROR_CHECK(esp_lcd_panel_reset(panel_handle));
         ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle));
+        trace.End(BootPhase::kRgbPanelInit);
+
+        // Show the splash and light the panel before LVGL starts
+        if (DISPLAY_DMA_COPY)
+        {
+            FramebufferDma::GetInstance().Start();
+        }
+        trace.Begin(BootPhase::kSplash);
+        if (scanout_ != nullptr && scanout_->bytes_per_pixel() == 1)
+        {
+            // The splash is RGB565; the zeroed luminance buffer shows black until LVGL draws
+            ESP_LOGI(TAG, "Monochrome frame buffers, no boot splash");
+        }
+        else if (scanout_ != nullptr)
+        {
+            show_boot_splash(static_cast<uint16_t *>(scanout_->frame_buffer(0)), DISPLAY_WIDTH, DISPLAY_HEIGHT);
+        }
+        else
+        {
+            show_boot_splash(panel_handle, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+        }
+        trace.End(BootPhase::kSplash);
+        if (backlight_)
+        {
+            backlight_->RestoreBrightness();
+        }
+
+        // The display pins the LVGL task to the core the band helper leaves free
+        if (DISPLAY_PARALLEL_BANDS)
+        {
+            BandScheduler::GetInstance().Start(1, 4);
+        }
+        auto *display = new RgbLcdDisplay(panel_io, panel_handle,
+                                          DISPLAY_WIDTH, DISPLAY_HEIGHT, DISPLAY_OFFSET_X, DISPLAY_OFFSET_Y, DISPLAY_MIRROR_X,
+                                          DISPLAY_MIRROR_Y, DISPLAY_SWAP_XY,
+                                          DISPLAY_DIRTY_RECT_REFRESH ? RgbRefreshMode::kDirtyRect : RgbRefreshMode::kFullRefresh,
+                                          profile, scanout_);
+        RegisterRefreshTimings(display, rgb_config.timings.pclk_hz);
+        if (DISPLAY_STATUS_OVERLAY)
+        {
+            display->MoveStatusToOverlay();
+        }
+        if (DISPLAY_VSYNC_REFRESH)
+        {
+            display->StartVsyncRefresh();
+        }
+        display_ = display;
 
-        display_ = new RgbLcdDisplay(panel_io, panel_handle,
-                                     DISPLAY_WIDTH, DISPLAY_HEIGHT, DISPLAY_OFFSET_X, DISPLAY_OFFSET_Y, DISPLAY_MIRROR_X,
-                                     DISPLAY_MIRROR_Y, DISPLAY_SWAP_XY);
+        // Buffer sizes the profile and the scan-out stage ask for, next to what the panel driver and
+        // LVGL really took
+        FramebufferFootprint footprint = GetFramebufferFootprint(profile, DISPLAY_WIDTH, DISPLAY_HEIGHT, DISPLAY_SWAP_XY,
+                                                                 scanout_ != nullptr && scanout_->bytes_per_pixel() == 1);
+        FramebufferFootprint layers = display->GetLayerFootprint();
+        const size_t lut_bytes = scanout_ != nullptr ? PanelScanout::lut_bytes() : 0;
+        ESP_LOGI(TAG, "Frame buffer profile %s: %d fb, bounce 2x%d lines, draw %dx%d lines", profile.name,
+                 profile.num_fbs, profile.bounce_buffer_lines, profile.num_draw_buffers, profile.draw_buffer_lines);
+        ESP_LOGI(TAG, "  PSRAM: %u bytes (frame buffers %u, layer surfaces %u)",
+                 (unsigned)(footprint.psram_bytes + layers.psram_bytes), (unsigned)footprint.psram_bytes,
+                 (unsigned)layers.psram_bytes);
+        ESP_LOGI(TAG, "  internal: %u bytes (bounce and draw buffers %u, scan-out LUTs %u, layer draw buffers %u)",
+                 (unsigned)(footprint.internal_bytes + lut_bytes + layers.internal_bytes),
+                 (unsigned)footprint.internal_bytes, (unsigned)lut_bytes, (unsigned)layers.internal_bytes);
+        ESP_LOGI(TAG, "  measured: PSRAM %d bytes, internal %d bytes (panel driver, LVGL and UI included)",
+                 (int)(psram_free - heap_caps_get_free_size(MALLOC_CAP_SPIRAM)),
+                 (int)(internal_free - heap_caps_get_free_size(MALLOC_CAP_INTERNAL)));
+    }
+
+    // Switchable refresh rates, only the pixel clock changes so the panel keeps its porches
+    void RegisterRefreshTimings(RgbLcdDisplay *display, uint32_t boot_pclk_hz)
+    {
+        static constexpr RgbRefreshTiming kCandidates[] = {
+            {30, GC9503_376_960_PANEL_PCLK_HZ(30)},
+            {45, GC9503_376_960_PANEL_PCLK_HZ(45)},
+            {60, GC9503_376_960_PANEL_PCLK_HZ(60)},
+        };
+        RgbRefreshTiming timings[sizeof(kCandidates) / sizeof(kCandidates[0]) + 1];
+        int count = 0;
+        for (const auto &timing : kCandidates)
+        {
+            if (timing.pclk_hz <= DISPLAY_MAX_PCLK_HZ)
+            {
+                timings[count++] = timing;
+            }
+            else
+            {
+                ESP_LOGW(TAG, "%d Hz dropped: needs a %.1f MHz pixel clock, above the %.1f MHz PSRAM limit",
+                         timing.hz, timing.pclk_hz / 1e6f, DISPLAY_MAX_PCLK_HZ / 1e6f);
+            }
+        }
+        // The boot timing stays selectable under its own rate
+        int boot_hz = (boot_pclk_hz + GC9503_376_960_PANEL_PCLK_HZ(1) / 2) / GC9503_376_960_PANEL_PCLK_HZ(1);
+        timings[count++] = {boot_hz, boot_pclk_hz};
+        display->SetRefreshTimings(timings, count, boot_hz);
     }
 
 public:
@@ -107,20 +235,19 @@ public:
 
         // Initialize audio codec to control PA amplifier pin only
         // Note: Real Kevin Yuying 313 uses ES8311 via I2C, we only control PA enable pin
+        auto &trace = BootTrace::GetInstance();
+        trace.Begin(BootPhase::kPaPin);
         audio_codec_ = new DummyAudioCodec(AUDIO_CODEC_PA_PIN);
+        trace.End(BootPhase::kPaPin);
 
         // Initialize backlight
+        trace.Begin(BootPhase::kPwmBacklight);
         backlight_ = new PwmBacklight(DISPLAY_BACKLIGHT_PIN, DISPLAY_BACKLIGHT_OUTPUT_INVERT);
+        trace.End(BootPhase::kPwmBacklight);
 
-        // Initialize display
+        // Initialize display, the backlight is restored as soon as the splash is drawn
         InitializeRGB_GC9503V_Display();
 
-        // Restore backlight brightness
-        if (backlight_)
-        {
-            backlight_->RestoreBrightness();
-        }
-
         ESP_LOGI(TAG, "Kevin Yuying 313 LCD board initialized");
     }
 
@@ -0,0 +1,112 @@
+#include "boot_trace.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <cstdio>
+#include <string>
+
+#define TAG "BootTrace"
+
+static const char *const kBootPhaseNames[] = {
+    "app_main",
+    "nvs_init",
+    "pa_pin",
+    "pwm_backlight",
+    "panel_io_3wire_spi",
+    "gc9503_init_upload",
+    "rgb_panel_init",
+    "boot_splash",
+    "lvgl_init",
+    "display_add",
+    "setup_ui",
+    "first_frame",
+};
+static_assert(sizeof(kBootPhaseNames) / sizeof(kBootPhaseNames[0]) == static_cast<size_t>(BootPhase::kCount),
+              "every boot phase needs a name");
+
+BootTrace::BootTrace()
+{
+    for (size_t i = 0; i < static_cast<size_t>(BootPhase::kCount); i++)
+    {
+        start_us_[i] = end_us_[i] = -1;
+    }
+}
+
+void BootTrace::Begin(BootPhase phase)
+{
+    size_t index = static_cast<size_t>(phase);
+    if (start_us_[index] < 0)
+    {
+        start_us_[index] = esp_timer_get_time();
+    }
+}
+
+void BootTrace::End(BootPhase phase)
+{
+    size_t index = static_cast<size_t>(phase);
+    if (start_us_[index] >= 0 && end_us_[index] < 0)
+    {
+        end_us_[index] = esp_timer_get_time();
+    }
+}
+
+void BootTrace::Mark(BootPhase phase)
+{
+    size_t index = static_cast<size_t>(phase);
+    if (start_us_[index] >= 0)
+    {
+        return;
+    }
+    start_us_[index] = end_us_[index] = esp_timer_get_time();
+    if (phase == BootPhase::kFirstFrame)
+    {
+        PrintSummary();
+    }
+}
+
+BootPhaseRecord BootTrace::GetRecord(BootPhase phase) const
+{
+    size_t index = static_cast<size_t>(phase);
+    return {kBootPhaseNames[index], start_us_[index], end_us_[index]};
+}
+
+int64_t BootTrace::GetTimeToFirstFrameUs() const
+{
+    return end_us_[static_cast<size_t>(BootPhase::kFirstFrame)];
+}
+
+void BootTrace::PrintSummary() const
+{
+    // Fixed rows and a one-line key=value form so boots can be diffed against each other
+    ESP_LOGI(TAG, "%-20s %10s %10s", "phase", "start ms", "took ms");
+    std::string line;
+    for (size_t i = 0; i < static_cast<size_t>(BootPhase::kCount); i++)
+    {
+        char value[24];
+        if (start_us_[i] < 0)
+        {
+            ESP_LOGI(TAG, "%-20s %10s %10s", kBootPhaseNames[i], "-", "-");
+            snprintf(value, sizeof(value), "=-");
+        }
+        else if (end_us_[i] < 0)
+        {
+            ESP_LOGI(TAG, "%-20s %10.1f %10s", kBootPhaseNames[i], start_us_[i] / 1000.0, "running");
+            snprintf(value, sizeof(value), "=running");
+        }
+        else if (end_us_[i] == start_us_[i])
+        {
+            // Instant events are reported by when they happened
+            ESP_LOGI(TAG, "%-20s %10.1f %10s", kBootPhaseNames[i], start_us_[i] / 1000.0, "");
+            snprintf(value, sizeof(value), "@%.1f", start_us_[i] / 1000.0);
+        }
+        else
+        {
+            ESP_LOGI(TAG, "%-20s %10.1f %10.1f", kBootPhaseNames[i], start_us_[i] / 1000.0,
+                     (end_us_[i] - start_us_[i]) / 1000.0);
+            snprintf(value, sizeof(value), "=%.1f", (end_us_[i] - start_us_[i]) / 1000.0);
+        }
+        line += line.empty() ? "" : " ";
+        line += kBootPhaseNames[i];
+        line += value;
+    }
+    ESP_LOGI(TAG, "boot: %s", line.c_str());
+}
@@ -0,0 +1,60 @@
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Boot phases in the order they run. Keep kBootPhaseNames in boot_trace.cc in sync.
+enum class BootPhase
+{
+    kAppMain,          // app_main entered (instant)
+    kNvsInit,
+    kPaPin,            // DummyAudioCodec PA enable pin
+    kPwmBacklight,     // LEDC timer and channel
+    kPanelIo,          // 3-wire SPI panel IO install
+    kGc9503InitUpload, // GC9503 soft reset and init command upload (auto_del_panel_io), RGB panel creation
+    kRgbPanelInit,     // RGB panel reset and start of scan-out
+    kSplash,
+    kLvglInit,         // lv_init + lvgl_port_init
+    kDisplayAdd,       // LVGL display registration
+    kSetupUi,
+    kFirstFrame,       // first LVGL frame presented (instant)
+    kCount,
+};
+
+struct BootPhaseRecord
+{
+    const char *name;
+    int64_t start_us; // esp_timer_get_time(), -1 if the phase has not run
+    int64_t end_us;   // -1 while the phase is running
+};
+
+// Timestamps boot phases with esp_timer_get_time(). Each phase is recorded once;
+// later calls for the same phase are ignored so hooks in per-frame paths are cheap.
+class BootTrace
+{
+public:
+    static BootTrace &GetInstance()
+    {
+        static BootTrace instance;
+        return instance;
+    }
+
+    void Begin(BootPhase phase);
+    void End(BootPhase phase);
+    // Record an instant event; marking kFirstFrame prints the summary
+    void Mark(BootPhase phase);
+
+    BootPhaseRecord GetRecord(BootPhase phase) const;
+    // From esp_timer start (early in the 2nd stage startup) to the first frame, -1 until then
+    int64_t GetTimeToFirstFrameUs() const;
+    void PrintSummary() const;
+
+private:
+    BootTrace();
+
+    int64_t start_us_[static_cast<size_t>(BootPhase::kCount)];
+    int64_t end_us_[static_cast<size_t>(BootPhase::kCount)];
+};
+
+#endif // BOOT_TRACE_H
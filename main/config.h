@@ -9,9 +9,64 @@
 #define DISPLAY_MIRROR_Y false
 #define DISPLAY_SWAP_XY true
 
+// Redraw only invalidated areas instead of the whole 376x960 frame on every refresh
+#define DISPLAY_DIRTY_RECT_REFRESH true
+
+// Frame buffer memory profile: kMaxFps, kBalanced, kMinMemory (one frame buffer, frees ~722 KB PSRAM)
+// or kTripleBuffer (a third frame buffer so a slow frame does not stall presentation)
+#define DISPLAY_FB_PROFILE FramebufferProfile::kBalanced
+
+// Log RGB565 rotation throughput (scalar vs. PIE) once at start-up
+#define DISPLAY_ROTATE_BENCHMARK false
+
+// Check the RGB565 blend kernels against LVGL's arithmetic and log their throughput at start-up
+#define DISPLAY_BLEND_BENCHMARK false
+
+// Check the XRGB8888 ordered dither kernel against its reference and log its cost per panel line
+#define DISPLAY_DITHER_BENCHMARK false
+
+// Render at the panel's vsync when something changed instead of polling on LVGL's refresh timer.
+// The ui queue log line reports input-to-photon latency for either setting.
+#define DISPLAY_VSYNC_REFRESH true
+
+// Split blending, rotation and back buffer sync into row bands rendered on both cores
+#define DISPLAY_PARALLEL_BANDS true
+
+// Time a full-screen redraw on one core and on both at start-up
+#define DISPLAY_BAND_BENCHMARK false
+
+// Copy wide back buffer sync areas and clear frame buffers with the GDMA copy engine instead of the CPU
+#define DISPLAY_DMA_COPY true
+
+// Fill the panel's bounce buffers from our own frame buffers instead of the driver's, through the
+// colour LUT: per-unit calibration from NVS ("display"/"color_lut") and night mode white point
+#define DISPLAY_SCANOUT_STAGE true
+
+// Tinted monochrome: 8-bit luminance frame buffers, half the PSRAM and scan-out bandwidth of
+// RGB565. LVGL renders L8, so every UI colour is reduced to its brightness, and the scan-out stage
+// shows level 0..255 on a ramp from black to DISPLAY_MONO_TINT (RGB565, 0xFFFF for grey). Needs
+// DISPLAY_SCANOUT_STAGE; the boot splash is skipped.
+#define DISPLAY_MONO_FRAMEBUFFER false
+#define DISPLAY_MONO_TINT 0xFFFF
+
+// Draw the status and notification labels into an overlay blended at scan-out instead of the
+// frame buffer, so status updates never redraw or copy frame buffer pixels. Needs
+// DISPLAY_SCANOUT_STAGE; the overlay's PSRAM surfaces are listed in the start-up footprint log.
+// Off by default for power: the labels keep the overlay on screen for the whole uptime, and
+// blending it from the bounce interrupt holds the CPU at full speed (PanelScanout's "scanout"
+// lock), so DFS never lowers the clock even on a static screen.
+#define DISPLAY_STATUS_OVERLAY false
+
+// Highest pixel clock the PSRAM bounce-buffer path sustains at 16 bpp with 80 MHz octal PSRAM.
+// Refresh rates that would need more are left out of the switchable set.
+#define DISPLAY_MAX_PCLK_HZ (21 * 1000 * 1000)
+
 #define DISPLAY_OFFSET_X 0
 #define DISPLAY_OFFSET_Y 0
 
+// Lowest CPU clock DFS may pick when neither LVGL nor the scan-out stage's per-pixel work is active
+#define PM_MIN_CPU_FREQ_MHZ 80
+
 #define DISPLAY_BACKLIGHT_PIN GPIO_NUM_4
 #define DISPLAY_BACKLIGHT_OUTPUT_INVERT false
 
@@ -0,0 +1,139 @@
+#include "band_scheduler.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_err.h>
+#include <cassert>
+
+#define TAG "BandScheduler"
+
+void BandScheduler::Start(int helper_core, int priority)
+{
+    if (helper_ != nullptr)
+    {
+        return;
+    }
+    helper_done_ = xSemaphoreCreateBinary();
+    assert(helper_done_ != nullptr);
+    helper_core_ = helper_core;
+    BaseType_t ret = xTaskCreatePinnedToCore(HelperTask, "band_helper", 4096, this, priority, &helper_,
+                                             helper_core);
+    if (ret != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to start the band helper, rendering stays on one core");
+        helper_ = nullptr;
+        helper_core_ = -1;
+        return;
+    }
+    ESP_LOGI(TAG, "Band helper running on core %d", helper_core);
+}
+
+void BandScheduler::HelperTask(void *arg)
+{
+    auto *self = static_cast<BandScheduler *>(arg);
+    const int core = xPortGetCoreID();
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // The caller may have finished every band and withdrawn the job before we woke up
+        uint32_t expected = kPosted;
+        if (!self->state_.compare_exchange_strong(expected, kRunning, std::memory_order_acquire))
+        {
+            continue;
+        }
+        int64_t busy_us = self->TakeBands(core);
+        portENTER_CRITICAL(&self->stats_lock_);
+        self->stats_.busy_us[core & 1] += busy_us;
+        self->stats_.split_busy_us += busy_us;
+        portEXIT_CRITICAL(&self->stats_lock_);
+        xSemaphoreGive(self->helper_done_);
+    }
+}
+
+int64_t BandScheduler::TakeBands(int core)
+{
+    int64_t busy_us = 0;
+    uint32_t bands = 0;
+    for (;;)
+    {
+        int band = next_band_.fetch_add(1, std::memory_order_relaxed);
+        if (band >= band_count_)
+        {
+            break;
+        }
+        int first = band * band_size_;
+        int end = first + band_size_ < count_ ? first + band_size_ : count_;
+        int64_t start_us = esp_timer_get_time();
+        fn_(ctx_, first, end);
+        busy_us += esp_timer_get_time() - start_us;
+        bands++;
+    }
+    portENTER_CRITICAL(&stats_lock_);
+    stats_.bands[core & 1] += bands;
+    portEXIT_CRITICAL(&stats_lock_);
+    return busy_us;
+}
+
+void BandScheduler::Run(int count, int band_size, BandFn fn, void *ctx)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    const int core = xPortGetCoreID();
+    const int band_count = (count + band_size - 1) / band_size;
+    if (helper_ == nullptr || band_count < 2 || core == helper_core_ || !parallel_.load(std::memory_order_relaxed) ||
+        job_in_flight_.exchange(true, std::memory_order_acquire))
+    {
+        int64_t start_us = esp_timer_get_time();
+        fn(ctx, 0, count);
+        int64_t busy_us = esp_timer_get_time() - start_us;
+        portENTER_CRITICAL(&stats_lock_);
+        stats_.jobs++;
+        stats_.bands[core & 1]++;
+        stats_.busy_us[core & 1] += busy_us;
+        portEXIT_CRITICAL(&stats_lock_);
+        return;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    fn_ = fn;
+    ctx_ = ctx;
+    count_ = count;
+    band_size_ = band_size;
+    band_count_ = band_count;
+    next_band_.store(0, std::memory_order_relaxed);
+    state_.store(kPosted, std::memory_order_release);
+    xTaskNotifyGive(helper_);
+
+    int64_t busy_us = TakeBands(core);
+
+    // Withdraw the job if the helper never got to it, otherwise wait until its last band is done
+    uint32_t expected = kPosted;
+    bool helped = !state_.compare_exchange_strong(expected, kIdle, std::memory_order_acq_rel);
+    if (helped)
+    {
+        xSemaphoreTake(helper_done_, portMAX_DELAY);
+        state_.store(kIdle, std::memory_order_release);
+    }
+    job_in_flight_.store(false, std::memory_order_release);
+    int64_t wall_us = esp_timer_get_time() - start_us;
+
+    portENTER_CRITICAL(&stats_lock_);
+    stats_.jobs++;
+    stats_.busy_us[core & 1] += busy_us;
+    if (helped)
+    {
+        stats_.split_jobs++;
+        stats_.split_wall_us += wall_us;
+        stats_.split_busy_us += busy_us;
+    }
+    portEXIT_CRITICAL(&stats_lock_);
+}
+
+BandStats BandScheduler::GetStats()
+{
+    portENTER_CRITICAL(&stats_lock_);
+    BandStats stats = stats_;
+    portEXIT_CRITICAL(&stats_lock_);
+    return stats;
+}
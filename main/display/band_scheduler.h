@@ -0,0 +1,89 @@
+#ifndef BAND_SCHEDULER_H
+#define BAND_SCHEDULER_H
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <atomic>
+#include <cstdint>
+
+struct BandStats
+{
+    uint32_t jobs = 0;           // Run calls
+    uint32_t split_jobs = 0;     // Run calls the helper core took part in
+    uint32_t bands[2] = {};      // bands processed per core
+    int64_t busy_us[2] = {};     // time spent in band callbacks per core
+    int64_t split_wall_us = 0;   // wall time of the split jobs, caller's view
+    int64_t split_busy_us = 0;   // busy time of both cores during the split jobs
+};
+
+// Row-parallel work split into bands that the calling task and a helper task pinned to the other
+// core pull from a shared counter until none are left. Bands are taken dynamically rather than
+// halved up front, so when one core is held up (the bounce buffer ISR shares core 0 with the LVGL
+// task) the other one takes more. Run returns once every band is done, the callers' buffers are then consistent.
+// Callers must write disjoint rows from each band. A Run issued while another one is in flight
+// (from inside a band, or from a second task) executes inline.
+class BandScheduler
+{
+public:
+    typedef void (*BandFn)(void *ctx, int first, int end);
+
+    static BandScheduler &GetInstance()
+    {
+        static BandScheduler instance;
+        return instance;
+    }
+
+    // Starts the helper task, until then Run executes inline on the caller
+    void Start(int helper_core, int priority);
+    // -1 when not started
+    int helper_core() const { return helper_core_; }
+    // Keeps Run on the calling core while false, for comparing against a single core
+    void set_parallel(bool parallel) { parallel_.store(parallel, std::memory_order_relaxed); }
+
+    // Calls fn over [0, count) in bands of band_size items. Jobs with fewer than two bands, or
+    // Run calls from the helper's own core, are not split.
+    void Run(int count, int band_size, BandFn fn, void *ctx);
+
+    BandStats GetStats();
+
+private:
+    enum State : uint32_t
+    {
+        kIdle,
+        kPosted,  // job published, helper not in yet
+        kRunning, // helper is taking bands
+    };
+
+    BandScheduler() = default;
+    BandScheduler(const BandScheduler &) = delete;
+    BandScheduler &operator=(const BandScheduler &) = delete;
+
+    TaskHandle_t helper_ = nullptr;
+    int helper_core_ = -1;
+    SemaphoreHandle_t helper_done_ = nullptr;
+    std::atomic<uint32_t> state_{kIdle};
+    std::atomic<bool> job_in_flight_{false};
+    std::atomic<bool> parallel_{true};
+
+    // Current job, written by Run before it is posted
+    BandFn fn_ = nullptr;
+    void *ctx_ = nullptr;
+    int count_ = 0;
+    int band_size_ = 0;
+    int band_count_ = 0;
+    std::atomic<int> next_band_{0};
+
+    portMUX_TYPE stats_lock_ = portMUX_INITIALIZER_UNLOCKED;
+    BandStats stats_;
+
+    static void HelperTask(void *arg);
+    // Takes bands until none are left, returns the busy time
+    int64_t TakeBands(int core);
+};
+
+// Time a full-screen redraw (fill, faded panel, rotation, back buffer sync) on one core and on
+// both, and log the per-core split; returns 1 when the two frames differ
+int BandSchedulerBenchmark();
+
+#endif // BAND_SCHEDULER_H
@@ -0,0 +1,132 @@
+#include "band_scheduler.h"
+#include "rgb565_blend.h"
+#include "rgb565_rotate.h"
+#include "bench_util.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include <cstring>
+
+#define TAG "BandBench"
+
+// The panel as the rotated path sees it: LVGL renders 960x376 in bands of 16 lines in internal
+// RAM, each band is rotated into the 376x960 PSRAM back buffer, then the frame is copied over
+static constexpr int kLogicalWidth = 960;
+static constexpr int kLogicalHeight = 376;
+static constexpr int kDrawLines = 16;
+static constexpr int kRotateBandColumns = 64;
+static constexpr int kSyncBandRows = 16;
+
+struct RedrawBuffers
+{
+    uint16_t *draw;
+    uint16_t *front;
+    uint16_t *back;
+};
+
+struct RotateBand
+{
+    const uint16_t *src;
+    int lines;
+    int y;
+    uint16_t *fb;
+};
+
+struct SyncFrame
+{
+    const uint16_t *src;
+    uint16_t *dst;
+};
+
+// Same mapping as RgbLcdDisplay with mirror_x: logical (x, y) lands on panel row x, column 375 - y
+static void RotateColumns(void *ctx, int first, int end)
+{
+    const auto &band = *static_cast<const RotateBand *>(ctx);
+    const int panel_x1 = kLogicalHeight - band.y - band.lines;
+    uint16_t *dst = band.fb + first * kLogicalHeight + panel_x1;
+    rgb565_rotate_swap_xy(band.src + first, end - first, band.lines, kLogicalWidth, dst, kLogicalHeight, true, false);
+}
+
+static void CopyRows(void *ctx, int first, int end)
+{
+    const auto &frame = *static_cast<const SyncFrame *>(ctx);
+    const size_t offset = static_cast<size_t>(first) * kLogicalHeight;
+    memcpy(frame.dst + offset, frame.src + offset, static_cast<size_t>(end - first) * kLogicalHeight * 2);
+}
+
+static void Redraw(const RedrawBuffers &buffers, int frame)
+{
+    auto &scheduler = BandScheduler::GetInstance();
+    for (int y = 0; y < kLogicalHeight; y += kDrawLines)
+    {
+        const int lines = y + kDrawLines <= kLogicalHeight ? kDrawLines : kLogicalHeight - y;
+        rgb565_fill(buffers.draw, kLogicalWidth, lines, kLogicalWidth * 2, static_cast<uint16_t>(0x1082 * frame),
+                    nullptr, 0, 255);
+        rgb565_fill(buffers.draw, kLogicalWidth, lines, kLogicalWidth * 2, 0xFD20, nullptr, 0, 128);
+        RotateBand band = {buffers.draw, lines, y, buffers.back};
+        scheduler.Run(kLogicalWidth, kRotateBandColumns, RotateColumns, &band);
+    }
+    // The frame just drawn goes to the buffer that was scanned out meanwhile
+    SyncFrame sync = {buffers.back, buffers.front};
+    scheduler.Run(kLogicalWidth, kSyncBandRows, CopyRows, &sync);
+}
+
+static double MeasureUs(const RedrawBuffers &buffers)
+{
+    int frame = 0;
+    return BenchMeasureUs([&] { Redraw(buffers, frame++); });
+}
+
+int BandSchedulerBenchmark()
+{
+    const size_t fb_bytes = static_cast<size_t>(kLogicalWidth) * kLogicalHeight * 2;
+    RedrawBuffers buffers = {
+        static_cast<uint16_t *>(heap_caps_aligned_alloc(16, kLogicalWidth * kDrawLines * 2, MALLOC_CAP_INTERNAL)),
+        static_cast<uint16_t *>(heap_caps_aligned_alloc(16, fb_bytes, MALLOC_CAP_SPIRAM)),
+        static_cast<uint16_t *>(heap_caps_aligned_alloc(16, fb_bytes, MALLOC_CAP_SPIRAM)),
+    };
+    auto reference = static_cast<uint16_t *>(heap_caps_malloc(fb_bytes, MALLOC_CAP_SPIRAM));
+    if (buffers.draw == nullptr || buffers.front == nullptr || buffers.back == nullptr || reference == nullptr)
+    {
+        ESP_LOGE(TAG, "Failed to allocate buffers");
+        heap_caps_free(buffers.draw);
+        heap_caps_free(buffers.front);
+        heap_caps_free(buffers.back);
+        heap_caps_free(reference);
+        return 1;
+    }
+
+    // Started here when the board has not done it yet, the helper stays parked afterwards
+    auto &scheduler = BandScheduler::GetInstance();
+    scheduler.Start(1, 4);
+
+    scheduler.set_parallel(false);
+    Redraw(buffers, 1);
+    memcpy(reference, buffers.front, fb_bytes);
+    const double single_us = MeasureUs(buffers);
+
+    // Bands on both cores must draw the same frame
+    scheduler.set_parallel(true);
+    memset(buffers.front, 0, fb_bytes);
+    Redraw(buffers, 1);
+    const bool match = BenchMatches(TAG, "parallel redraw", buffers.front, reference, fb_bytes / 2);
+    BandStats before = scheduler.GetStats();
+    const int64_t start_us = esp_timer_get_time();
+    const double dual_us = MeasureUs(buffers);
+    const int64_t wall = esp_timer_get_time() - start_us;
+    BandStats after = scheduler.GetStats();
+
+    const int64_t busy0 = after.busy_us[0] - before.busy_us[0];
+    const int64_t busy1 = after.busy_us[1] - before.busy_us[1];
+    ESP_LOGI(TAG, "full redraw %dx%d: one core %.2f ms, both cores %.2f ms (x%.2f)", kLogicalWidth, kLogicalHeight,
+             single_us / 1000, dual_us / 1000, single_us / dual_us);
+    ESP_LOGI(TAG, "  core 0 busy %.0f%% (%lu bands), core 1 busy %.0f%% (%lu bands)",
+             wall > 0 ? 100.0f * busy0 / wall : 0.0f, (unsigned long)(after.bands[0] - before.bands[0]),
+             wall > 0 ? 100.0f * busy1 / wall : 0.0f, (unsigned long)(after.bands[1] - before.bands[1]));
+
+    heap_caps_free(buffers.draw);
+    heap_caps_free(buffers.front);
+    heap_caps_free(buffers.back);
+    heap_caps_free(reference);
+    return match ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <cstddef>
+#include <cstdint>
+
+// Helpers of the kernel benchmarks (DISPLAY_*_BENCHMARK in config.h, sim/bench on the host). Each
+// benchmark checks its kernels against an independent reference before timing them and returns
+// the number of failed checks, which the host runner turns into its exit status.
+
+static constexpr int64_t kBenchMinRunTimeUs = 200 * 1000;
+
+// Calls run until at least kBenchMinRunTimeUs have passed, returns the average microseconds per call
+template <typename Run>
+double BenchMeasureUs(Run &&run)
+{
+    const int64_t start = esp_timer_get_time();
+    int64_t elapsed = 0;
+    int iterations = 0;
+    do
+    {
+        run();
+        iterations++;
+        elapsed = esp_timer_get_time() - start;
+    } while (elapsed < kBenchMinRunTimeUs);
+    return static_cast<double>(elapsed) / iterations;
+}
+
+// Compares count elements against the reference, logs the first difference; true when they match
+template <typename T>
+bool BenchMatches(const char *tag, const char *what, const T *out, const T *expected, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (out[i] != expected[i])
+        {
+            ESP_LOGE(tag, "%s: element %u is 0x%lx, expected 0x%lx", what, static_cast<unsigned>(i),
+                     static_cast<unsigned long>(out[i]), static_cast<unsigned long>(expected[i]));
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // BENCH_UTIL_H
@@ -0,0 +1,153 @@
+#include "boot_splash.h"
+#include "framebuffer_dma.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_partition.h>
+#include <esp_lcd_panel_rgb.h>
+#include <cstring>
+
+#define TAG "BootSplash"
+
+// Partition layout, little endian:
+//   header, then raw RGB565 pixels or (run length, colour) uint16_t pairs,
+//   in panel scan order (already rotated for the panel by the packer)
+struct SplashHeader
+{
+    uint32_t magic;
+    uint16_t width;
+    uint16_t height;
+    uint16_t encoding;
+    uint16_t reserved;
+    uint32_t data_size;
+};
+static_assert(sizeof(SplashHeader) == 16, "splash header is 16 bytes");
+
+static constexpr uint32_t kSplashMagic = 0x314c5053; // "SPL1"
+static constexpr uint16_t kEncodingRaw = 0;
+static constexpr uint16_t kEncodingRle = 1;
+static constexpr uint16_t kFallbackBackground = 0x0000;
+
+// Fill with 32-bit stores, runs cover whole rows of the 376 pixel wide frame
+static void FillRgb565(uint16_t *dst, uint32_t count, uint16_t color)
+{
+    if ((reinterpret_cast<uintptr_t>(dst) & 2) && count > 0)
+    {
+        *dst++ = color;
+        count--;
+    }
+    uint32_t pattern = (static_cast<uint32_t>(color) << 16) | color;
+    uint32_t *dst32 = reinterpret_cast<uint32_t *>(dst);
+    for (uint32_t i = 0; i < count / 2; i++)
+    {
+        dst32[i] = pattern;
+    }
+    if (count & 1)
+    {
+        dst[count - 1] = color;
+    }
+}
+
+static bool DecodeRle(const uint16_t *runs, uint32_t run_words, uint16_t *frame, uint32_t pixels)
+{
+    uint32_t pos = 0;
+    for (uint32_t i = 0; i + 1 < run_words; i += 2)
+    {
+        uint32_t length = runs[i];
+        if (length == 0 || pos + length > pixels)
+        {
+            return false;
+        }
+        FillRgb565(frame + pos, length, runs[i + 1]);
+        pos += length;
+    }
+    return pos == pixels;
+}
+
+static bool DrawFromPartition(uint16_t *frame, int width, int height)
+{
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                                BOOT_SPLASH_PARTITION);
+    if (partition == nullptr)
+    {
+        ESP_LOGW(TAG, "No '%s' partition", BOOT_SPLASH_PARTITION);
+        return false;
+    }
+
+    // Map instead of reading so the image goes from flash cache into the frame buffer once
+    const void *mapped = nullptr;
+    esp_partition_mmap_handle_t handle;
+    if (esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &mapped, &handle) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Failed to map '%s'", BOOT_SPLASH_PARTITION);
+        return false;
+    }
+
+    const uint32_t pixels = width * height;
+    SplashHeader header;
+    memcpy(&header, mapped, sizeof(header));
+    const uint16_t *data = reinterpret_cast<const uint16_t *>(static_cast<const uint8_t *>(mapped) + sizeof(header));
+    bool ok = header.magic == kSplashMagic && header.width == width && header.height == height &&
+              header.data_size <= partition->size - sizeof(header);
+    if (!ok)
+    {
+        ESP_LOGW(TAG, "Splash image missing or not %dx%d", width, height);
+    }
+    else if (header.encoding == kEncodingRaw)
+    {
+        ok = header.data_size == pixels * 2;
+        if (ok)
+        {
+            memcpy(frame, data, pixels * 2);
+        }
+    }
+    else if (header.encoding == kEncodingRle)
+    {
+        ok = DecodeRle(data, header.data_size / 2, frame, pixels);
+        if (!ok)
+        {
+            ESP_LOGW(TAG, "Corrupt splash image");
+        }
+    }
+    else
+    {
+        ESP_LOGW(TAG, "Unknown splash encoding %u", header.encoding);
+        ok = false;
+    }
+
+    esp_partition_munmap(handle);
+    return ok;
+}
+
+esp_err_t show_boot_splash(esp_lcd_panel_handle_t panel, int width, int height)
+{
+    // The panel scans out frame buffer 0 until the first buffer switch
+    void *fb = nullptr;
+    esp_err_t ret = esp_lcd_rgb_panel_get_frame_buffer(panel, 1, &fb);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to get frame buffer");
+        return ret;
+    }
+    return show_boot_splash(static_cast<uint16_t *>(fb), width, height);
+}
+
+esp_err_t show_boot_splash(uint16_t *frame, int width, int height)
+{
+    // In bounce buffer mode the CPU copies the frame through the cache, so no write-back is needed
+    const char *source = "partition";
+    if (!DrawFromPartition(frame, width, height))
+    {
+        // Nothing branded to show, the screen stays black until LVGL's first frame. A clear of
+        // the whole frame is the copy engine's job; the panel reads the buffer through
+        // the cache meanwhile, so lines it fetched before the fill landed are dropped afterwards
+        auto &dma = FramebufferDma::GetInstance();
+        const size_t bytes = static_cast<size_t>(width) * height * 2;
+        dma.Fill16(frame, kFallbackBackground, bytes);
+        dma.Wait();
+        dma.Invalidate(frame, bytes);
+        source = "fallback";
+    }
+
+    ESP_LOGI(TAG, "Splash (%s) shown at %lld ms", source, (long long)(esp_timer_get_time() / 1000));
+    return ESP_OK;
+}
@@ -0,0 +1,20 @@
+#ifndef BOOT_SPLASH_H
+#define BOOT_SPLASH_H
+
+#include <esp_err.h>
+#include <esp_lcd_types.h>
+#include <cstdint>
+
+// Partition holding the pre-rendered splash, written by tools/pack_splash.py
+#define BOOT_SPLASH_PARTITION "splash"
+
+// Write the boot splash straight into the frame buffer the RGB panel is scanning
+// out, before LVGL exists. The image is decoded from the splash partition, which
+// holds a full raw frame when run-length coding does not pay off. If it is missing
+// or does not match the panel there is no branded screen: the frame is only
+// cleared to black until LVGL draws its first frame.
+esp_err_t show_boot_splash(esp_lcd_panel_handle_t panel, int width, int height);
+// Same, into a frame buffer the caller scans out (see panel_scanout.h)
+esp_err_t show_boot_splash(uint16_t *frame, int width, int height);
+
+#endif // BOOT_SPLASH_H
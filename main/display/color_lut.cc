@@ -0,0 +1,110 @@
+#include "color_lut.h"
+#include <esp_log.h>
+#include <nvs.h>
+#include <algorithm>
+#include <cmath>
+
+#define TAG "ColorLut"
+
+static void FillChannel(uint8_t *table, int size, float gamma, float gain)
+{
+    const float max = size - 1;
+    for (int i = 0; i < size; i++)
+    {
+        float out = gain * std::pow(i / max, gamma) * max;
+        table[i] = static_cast<uint8_t>(std::clamp(std::lround(out), 0L, static_cast<long>(max)));
+    }
+}
+
+ColorLut ColorLut::Identity()
+{
+    static const float kOnes[3] = {1.0f, 1.0f, 1.0f};
+    return FromGammaGain(kOnes, kOnes);
+}
+
+ColorLut ColorLut::FromGammaGain(const float gamma[3], const float gain[3])
+{
+    ColorLut lut;
+    FillChannel(lut.r, 32, gamma[0], gain[0]);
+    FillChannel(lut.g, 64, gamma[1], gain[1]);
+    FillChannel(lut.b, 32, gamma[2], gain[2]);
+    return lut;
+}
+
+// Black body colour (Tanner Helland's fit to the CIE data) for 1000 K to 6600 K, where red saturates
+static void BlackBody(float kelvin, float rgb[3])
+{
+    const float t = kelvin / 100.0f;
+    rgb[0] = 1.0f;
+    rgb[1] = std::clamp((99.4708025861f * std::log(t) - 161.1195681661f) / 255.0f, 0.0f, 1.0f);
+    rgb[2] = t <= 19.0f ? 0.0f : std::clamp((138.5177312231f * std::log(t - 10.0f) - 305.0447927307f) / 255.0f, 0.0f, 1.0f);
+}
+
+ColorLut ColorLut::WhitePoint(int kelvin)
+{
+    static const float kLinear[3] = {1.0f, 1.0f, 1.0f};
+    float white[3];
+    float target[3];
+    BlackBody(6500.0f, white);
+    BlackBody(std::clamp(kelvin, 1000, 6500), target);
+    const float gain[3] = {target[0] / white[0], target[1] / white[1], target[2] / white[2]};
+    return FromGammaGain(kLinear, gain);
+}
+
+bool ColorLut::LoadCalibration(ColorLut *lut)
+{
+    nvs_handle_t handle;
+    if (nvs_open(COLOR_LUT_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK)
+    {
+        return false;
+    }
+    ColorLut stored;
+    size_t size = sizeof(stored);
+    esp_err_t ret = nvs_get_blob(handle, COLOR_LUT_NVS_KEY, &stored, &size);
+    nvs_close(handle);
+    if (ret != ESP_OK || size != sizeof(ColorLut))
+    {
+        if (ret != ESP_ERR_NVS_NOT_FOUND)
+        {
+            ESP_LOGW(TAG, "Ignoring colour calibration (%s, %u bytes)", esp_err_to_name(ret), (unsigned)size);
+        }
+        return false;
+    }
+    for (int i = 0; i < 64; i++)
+    {
+        if ((i < 32 && (stored.r[i] > 31 || stored.b[i] > 31)) || stored.g[i] > 63)
+        {
+            ESP_LOGW(TAG, "Ignoring colour calibration, entry %d out of range", i);
+            return false;
+        }
+    }
+    *lut = stored;
+    return true;
+}
+
+ColorLut ColorLut::Then(const ColorLut &other) const
+{
+    ColorLut lut;
+    for (int i = 0; i < 32; i++)
+    {
+        lut.r[i] = other.r[r[i]];
+        lut.b[i] = other.b[b[i]];
+    }
+    for (int i = 0; i < 64; i++)
+    {
+        lut.g[i] = other.g[g[i]];
+    }
+    return lut;
+}
+
+bool ColorLut::IsIdentity() const
+{
+    for (int i = 0; i < 64; i++)
+    {
+        if ((i < 32 && (r[i] != i || b[i] != i)) || g[i] != i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef COLOR_LUT_H
+#define COLOR_LUT_H
+
+#include <cstdint>
+
+// NVS location of the per-unit calibration written in production, a raw ColorLut blob
+#define COLOR_LUT_NVS_NAMESPACE "display"
+#define COLOR_LUT_NVS_KEY "color_lut"
+
+// Per-channel colour correction of RGB565 pixels: each table maps a channel value to the value
+// sent to the panel, at the channel's own depth
+struct ColorLut
+{
+    uint8_t r[32];
+    uint8_t g[64];
+    uint8_t b[32];
+
+    static ColorLut Identity();
+    // out = gain * in^gamma per channel (r, g, b), both sides normalised to 0..1
+    static ColorLut FromGammaGain(const float gamma[3], const float gain[3]);
+    // Night mode: the white point of a black body at kelvin, 6500 K and above leave colours as they are
+    static ColorLut WhitePoint(int kelvin);
+    // Calibration from NVS, false when the unit has none or it does not fit
+    static bool LoadCalibration(ColorLut *lut);
+
+    // This correction followed by other, e.g. the panel calibration then night mode
+    ColorLut Then(const ColorLut &other) const;
+    bool IsIdentity() const;
+};
+
+#endif // COLOR_LUT_H
@@ -12,15 +12,9 @@ Display::Display()
         .callback = [](void *arg)
         {
             Display *display = static_cast<Display *>(arg);
-            DisplayLockGuard lock(display);
-            if (display->notification_label_)
-            {
-                lv_obj_add_flag(display->notification_label_, LV_OBJ_FLAG_HIDDEN);
-            }
-            if (display->status_label_)
-            {
-                lv_obj_clear_flag(display->status_label_, LV_OBJ_FLAG_HIDDEN);
-            }
+            display->ui_queue_.Post(UiCommandType::kHideNotification, nullptr, 0,
+                                    display->shown_notification_generation_.load(std::memory_order_relaxed));
+            display->RequestRefresh();
         },
         .arg = this,
         .dispatch_method = ESP_TIMER_TASK,
@@ -28,17 +22,6 @@ Display::Display()
         .skip_unhandled_events = false,
     };
     ESP_ERROR_CHECK(esp_timer_create(&notification_timer_args, &notification_timer_));
-
-    // Create a power management lock
-    auto ret = esp_pm_lock_create(ESP_PM_APB_FREQ_MAX, 0, "display_update", &pm_lock_);
-    if (ret == ESP_ERR_NOT_SUPPORTED)
-    {
-        ESP_LOGI(TAG, "Power management not supported");
-    }
-    else
-    {
-        ESP_ERROR_CHECK(ret);
-    }
 }
 
 Display::~Display()
@@ -57,26 +40,12 @@ Display::~Display()
     {
         lv_obj_del(status_label_);
     }
-
-    if (pm_lock_ != nullptr)
-    {
-        esp_pm_lock_delete(pm_lock_);
-    }
 }
 
 void Display::SetStatus(const char *status)
 {
-    DisplayLockGuard lock(this);
-    if (status_label_ == nullptr)
-    {
-        return;
-    }
-    lv_label_set_text(status_label_, status);
-    lv_obj_clear_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
-    if (notification_label_)
-    {
-        lv_obj_add_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
-    }
+    ui_queue_.Post(UiCommandType::kSetStatus, status);
+    RequestRefresh();
 }
 
 void Display::ShowNotification(const std::string &notification, int duration_ms)
@@ -86,18 +55,114 @@ void Display::ShowNotification(const std::string &notification, int duration_ms)
 
 void Display::ShowNotification(const char *notification, int duration_ms)
 {
-    DisplayLockGuard lock(this);
-    if (notification_label_ == nullptr)
+    uint32_t generation = notification_generation_.fetch_add(1, std::memory_order_relaxed) + 1;
+    ui_queue_.Post(UiCommandType::kShowNotification, notification, duration_ms, generation);
+    RequestRefresh();
+}
+
+void Display::ProcessUiCommands()
+{
+    // Fold everything queued since the last frame into the final state, so a burst of status
+    // changes costs one label update. Bounded so a busy producer cannot stall the frame.
+    UiCommand command;
+    UiCommand status;
+    UiCommand notification;
+    bool has_status = false;
+    bool has_notification = false;
+    bool has_visibility = false;
+    UiCommandType visible = UiCommandType::kSetStatus;
+    uint32_t superseded = 0;
+    uint32_t count = 0;
+    int64_t now = esp_timer_get_time();
+
+    while (count < UiCommandQueue::kCapacity && ui_queue_.Pop(command))
+    {
+        if (unpresented_post_us_ == 0)
+        {
+            unpresented_post_us_ = command.post_us;
+        }
+        count++;
+        ui_queue_.RecordLatency(command, now);
+        switch (command.type)
+        {
+        case UiCommandType::kSetStatus:
+            superseded += has_status;
+            status = command;
+            has_status = true;
+            break;
+        case UiCommandType::kShowNotification:
+            superseded += has_notification;
+            notification = command;
+            has_notification = true;
+            break;
+        case UiCommandType::kHideNotification:
+        {
+            uint32_t shown = has_notification ? notification.generation
+                                              : shown_notification_generation_.load(std::memory_order_relaxed);
+            if (command.generation != shown)
+            {
+                // Timer of a notification that has been replaced since
+                superseded++;
+                continue;
+            }
+            break;
+        }
+        }
+        visible = command.type;
+        has_visibility = true;
+    }
+    if (count == 0)
+    {
+        return;
+    }
+    ui_queue_.RecordCoalesced(superseded);
+
+    if (has_status && status_label_)
+    {
+        lv_label_set_text(status_label_, status.text);
+    }
+    if (has_notification && notification_label_)
+    {
+        lv_label_set_text(notification_label_, notification.text);
+        shown_notification_generation_.store(notification.generation, std::memory_order_relaxed);
+        esp_timer_stop(notification_timer_);
+        ESP_ERROR_CHECK(esp_timer_start_once(notification_timer_, notification.duration_ms * 1000));
+    }
+
+    if (!has_visibility)
     {
         return;
     }
-    lv_label_set_text(notification_label_, notification);
-    lv_obj_clear_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
+    bool show_notification = visible == UiCommandType::kShowNotification;
+    if (notification_label_)
+    {
+        if (show_notification)
+        {
+            lv_obj_clear_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
+        }
+        else
+        {
+            lv_obj_add_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
     if (status_label_)
     {
-        lv_obj_add_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
+        if (show_notification)
+        {
+            lv_obj_add_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
+        }
+        else
+        {
+            lv_obj_clear_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
+        }
     }
+}
 
-    esp_timer_stop(notification_timer_);
-    ESP_ERROR_CHECK(esp_timer_start_once(notification_timer_, duration_ms * 1000));
-}
\ No newline at end of file
+void Display::RecordPresented(int64_t now_us)
+{
+    if (unpresented_post_us_ != 0)
+    {
+        ui_queue_.RecordPresented(unpresented_post_us_, now_us);
+        unpresented_post_us_ = 0;
+    }
+}
@@ -5,26 +5,36 @@
 #include <esp_timer.h>
 #include <esp_log.h>
 #include <esp_pm.h>
+#include <atomic>
 #include <string>
 
+#include "ui_command_queue.h"
+#include "pm_activity.h"
+
 class Display
 {
 public:
     Display();
     virtual ~Display();
 
+    // Safe to call from any task, the update is queued and applied by the LVGL task on its next frame
     virtual void SetStatus(const char *status);
     virtual void ShowNotification(const char *notification, int duration_ms = 3000);
     virtual void ShowNotification(const std::string &notification, int duration_ms = 3000);
 
     inline int width() const { return width_; }
     inline int height() const { return height_; }
+    // Panel refresh rate, displays without switchable timings report 0 and refuse every rate
+    virtual bool SetRefreshRate(int) { return false; }
+    virtual int refresh_rate() const { return 0; }
+    UiQueueStats GetUiQueueStats() const { return ui_queue_.GetStats(); }
 
 protected:
     int width_ = 0;
     int height_ = 0;
 
-    esp_pm_lock_handle_t pm_lock_ = nullptr;
+    // Held while a frame is rendered and flushed so DFS can drop the CPU clock between frames
+    PmActivityLock pm_lock_{ESP_PM_CPU_FREQ_MAX, "display_update"};
     lv_display_t *display_ = nullptr;
 
     lv_obj_t *notification_label_ = nullptr;
@@ -32,6 +42,23 @@ protected:
 
     esp_timer_handle_t notification_timer_ = nullptr;
 
+    UiCommandQueue ui_queue_;
+    // Bumped by every ShowNotification, lets a hide from an older notification's timer be ignored
+    std::atomic<uint32_t> notification_generation_{0};
+    std::atomic<uint32_t> shown_notification_generation_{0};
+
+    // Post time of the oldest command applied since the last presented frame, 0 if none
+    int64_t unpresented_post_us_ = 0;
+
+    // Applies the queued UI commands, called by the LVGL task with the LVGL lock held
+    void ProcessUiCommands();
+    // Called by the LVGL task once a frame is on screen (input-to-photon latency of the commands it
+    // applied), and after a refresh that presented nothing
+    void RecordPresented(int64_t now_us);
+    void DropUnpresented() { unpresented_post_us_ = 0; }
+    // A command was posted, displays that only render on request schedule a refresh here
+    virtual void RequestRefresh() {}
+
     friend class DisplayLockGuard;
     virtual bool Lock(int timeout_ms = 0) = 0;
     virtual void Unlock() = 0;
@@ -0,0 +1,180 @@
+#include "framebuffer_dma.h"
+#include <esp_log.h>
+#include <esp_err.h>
+#include <esp_timer.h>
+#include <esp_cache.h>
+#include <esp_memory_utils.h>
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+
+#define TAG "FramebufferDma"
+
+void FramebufferDma::Start()
+{
+    if (handle_ != nullptr)
+    {
+        return;
+    }
+    if (slots_ == nullptr)
+    {
+        slots_ = xSemaphoreCreateCounting(kBacklog, kBacklog);
+        assert(slots_ != nullptr);
+    }
+
+    async_memcpy_config_t config = ASYNC_MEMCPY_DEFAULT_CONFIG();
+    config.backlog = kBacklog;
+    config.sram_trans_align = 4;
+    // Non-zero lets the engine reach PSRAM at all
+    config.psram_trans_align = kAlign;
+    esp_err_t ret = esp_async_memcpy_install(&config, &handle_);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to install the async memcpy engine (%s), frame buffers are copied by the CPU",
+                 esp_err_to_name(ret));
+        handle_ = nullptr;
+        return;
+    }
+    ESP_LOGI(TAG, "Frame buffer copies go through GDMA");
+}
+
+bool FramebufferDma::OnTransferDone(async_memcpy_handle_t, async_memcpy_event_t *, void *ctx)
+{
+    auto *self = static_cast<FramebufferDma *>(ctx);
+    BaseType_t need_yield = pdFALSE;
+    xSemaphoreGiveFromISR(self->slots_, &need_yield);
+    return need_yield == pdTRUE;
+}
+
+bool FramebufferDma::Submit(void *dst, const void *src, size_t bytes)
+{
+    xSemaphoreTake(slots_, portMAX_DELAY);
+    esp_err_t ret = esp_async_memcpy(handle_, dst, const_cast<void *>(src), bytes, OnTransferDone, this);
+    if (ret != ESP_OK)
+    {
+        xSemaphoreGive(slots_);
+        ESP_LOGW(TAG, "Transfer of %u bytes refused (%s)", (unsigned)bytes, esp_err_to_name(ret));
+        return false;
+    }
+    in_flight_ = true;
+    portENTER_CRITICAL(&stats_lock_);
+    stats_.transfers++;
+    stats_.dma_bytes += bytes;
+    portEXIT_CRITICAL(&stats_lock_);
+    return true;
+}
+
+void FramebufferDma::Copy(void *dst, const void *src, size_t bytes)
+{
+    if (bytes == 0)
+    {
+        return;
+    }
+    const bool aligned = ((reinterpret_cast<uintptr_t>(dst) | reinterpret_cast<uintptr_t>(src) | bytes) % kAlign) == 0;
+    size_t done = 0;
+    if (handle_ != nullptr && aligned)
+    {
+        // The engine reads and writes PSRAM behind the cache: the CPU's pending writes to the source
+        // go out first, and the destination must not have lines left that could be written back
+        // over the copy later
+        if (esp_ptr_external_ram(src))
+        {
+            esp_cache_msync(const_cast<void *>(src), bytes,
+                            ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+        }
+        if (esp_ptr_external_ram(dst))
+        {
+            esp_cache_msync(dst, bytes,
+                            ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_INVALIDATE |
+                                ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+        }
+        while (done < bytes)
+        {
+            const size_t chunk = std::min(bytes - done, kMaxTransferBytes);
+            if (!Submit(static_cast<uint8_t *>(dst) + done, static_cast<const uint8_t *>(src) + done, chunk))
+            {
+                break;
+            }
+            done += chunk;
+        }
+        if (done == bytes)
+        {
+            return;
+        }
+    }
+
+    // After whatever is still in flight, so copies keep their order
+    Wait();
+    memcpy(static_cast<uint8_t *>(dst) + done, static_cast<const uint8_t *>(src) + done, bytes - done);
+    portENTER_CRITICAL(&stats_lock_);
+    stats_.cpu_copies++;
+    stats_.cpu_bytes += bytes - done;
+    portEXIT_CRITICAL(&stats_lock_);
+}
+
+void FramebufferDma::Fill16(void *dst, uint16_t value, size_t bytes)
+{
+    auto *pixels = static_cast<uint16_t *>(dst);
+    const size_t seed = std::min(bytes, kFillSeedBytes);
+    Wait();
+    for (size_t i = 0; i < seed / 2; i++)
+    {
+        pixels[i] = value;
+    }
+
+    // Every step reads what the one before wrote
+    auto *bytes_dst = static_cast<uint8_t *>(dst);
+    for (size_t filled = seed; filled < bytes;)
+    {
+        const size_t step = std::min(filled, bytes - filled);
+        Wait();
+        Copy(bytes_dst + filled, bytes_dst, step);
+        filled += step;
+    }
+}
+
+void FramebufferDma::Wait()
+{
+    if (!in_flight_)
+    {
+        return;
+    }
+    // Holding every slot means the engine has given them all back
+    int64_t start_us = esp_timer_get_time();
+    for (int i = 0; i < kBacklog; i++)
+    {
+        xSemaphoreTake(slots_, portMAX_DELAY);
+    }
+    for (int i = 0; i < kBacklog; i++)
+    {
+        xSemaphoreGive(slots_);
+    }
+    in_flight_ = false;
+    int64_t wait_us = esp_timer_get_time() - start_us;
+
+    portENTER_CRITICAL(&stats_lock_);
+    stats_.fence_waits++;
+    stats_.fence_wait_us += wait_us;
+    portEXIT_CRITICAL(&stats_lock_);
+}
+
+void FramebufferDma::Invalidate(void *dst, size_t bytes)
+{
+    if (handle_ == nullptr || !esp_ptr_external_ram(dst))
+    {
+        return;
+    }
+    esp_err_t ret = esp_cache_msync(dst, bytes, ESP_CACHE_MSYNC_FLAG_DIR_M2C);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Failed to invalidate %u bytes at %p (%s)", (unsigned)bytes, dst, esp_err_to_name(ret));
+    }
+}
+
+FramebufferDmaStats FramebufferDma::GetStats()
+{
+    portENTER_CRITICAL(&stats_lock_);
+    FramebufferDmaStats stats = stats_;
+    portEXIT_CRITICAL(&stats_lock_);
+    return stats;
+}
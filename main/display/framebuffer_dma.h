@@ -0,0 +1,77 @@
+#ifndef FRAMEBUFFER_DMA_H
+#define FRAMEBUFFER_DMA_H
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <esp_async_memcpy.h>
+#include <cstddef>
+#include <cstdint>
+
+struct FramebufferDmaStats
+{
+    uint32_t transfers = 0;    // transfers handed to the copy engine
+    uint64_t dma_bytes = 0;    // bytes they moved
+    uint32_t cpu_copies = 0;   // requests copied by the CPU instead (engine not running, misaligned)
+    uint64_t cpu_bytes = 0;
+    uint32_t fence_waits = 0;  // Wait calls that found transfers still in flight
+    int64_t fence_wait_us = 0; // time blocked in those
+};
+
+// Bulk frame buffer copies and fills on the GDMA memory-copy engine (esp_async_memcpy), so PSRAM
+// to PSRAM traffic runs while the CPU renders. Copy and Fill16 queue transfers and return at once,
+// Wait is the fence: it returns when everything queued before it has landed. Until then nothing
+// may write the destination (or the cache lines around it), and the source must stay as it is.
+// Requests the engine cannot take, because it is not running or the buffers are not aligned to
+// kAlign, are copied by the CPU on the spot, so the result is the same either way.
+// Meant for one task at a time: the board while booting, then the LVGL task.
+class FramebufferDma
+{
+public:
+    // PSRAM transfers move whole 16-byte blocks, addresses and sizes must be multiples of it
+    static constexpr size_t kAlign = 16;
+
+    static FramebufferDma &GetInstance()
+    {
+        static FramebufferDma instance;
+        return instance;
+    }
+
+    // Installs the copy engine, until then (or if that fails) everything is copied by the CPU
+    void Start();
+    bool started() const { return handle_ != nullptr; }
+
+    void Copy(void *dst, const void *src, size_t bytes);
+    // Fills bytes at dst with value: the CPU writes the first block, the engine then copies what is
+    // filled onto the rest, doubling it every step. Returns with the last step in flight.
+    void Fill16(void *dst, uint16_t value, size_t bytes);
+    // Blocks until every transfer queued so far has completed
+    void Wait();
+    // Drops cached lines of a range the engine wrote while it was also read through the cache (the
+    // buffer being scanned out), call after Wait. dst and bytes must be cache line aligned.
+    void Invalidate(void *dst, size_t bytes);
+
+    FramebufferDmaStats GetStats();
+
+private:
+    // Transfers in flight at once, and the largest single one: a full frame goes out as six
+    static constexpr int kBacklog = 16;
+    static constexpr size_t kMaxTransferBytes = 128 * 1024;
+    static constexpr size_t kFillSeedBytes = 1024;
+
+    FramebufferDma() = default;
+    FramebufferDma(const FramebufferDma &) = delete;
+    FramebufferDma &operator=(const FramebufferDma &) = delete;
+
+    async_memcpy_handle_t handle_ = nullptr;
+    // One per transfer the engine can hold, taken to submit and given back by the done interrupt
+    SemaphoreHandle_t slots_ = nullptr;
+    bool in_flight_ = false;
+
+    portMUX_TYPE stats_lock_ = portMUX_INITIALIZER_UNLOCKED;
+    FramebufferDmaStats stats_;
+
+    bool Submit(void *dst, const void *src, size_t bytes);
+    static bool OnTransferDone(async_memcpy_handle_t handle, async_memcpy_event_t *event, void *ctx);
+};
+
+#endif // FRAMEBUFFER_DMA_H
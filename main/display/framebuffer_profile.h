@@ -0,0 +1,59 @@
+#ifndef FRAMEBUFFER_PROFILE_H
+#define FRAMEBUFFER_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// How much memory the RGB display pipeline takes, picked once at board init
+enum class FramebufferProfile
+{
+    kMaxFps,       // two frame buffers, tall bounce buffers for fewer PSRAM bursts and interrupts
+    kBalanced,     // two frame buffers, the original buffer sizes
+    kMinMemory,    // one frame buffer drawn in place, small single draw buffer; may tear
+    kTripleBuffer, // three frame buffers and a paced present queue, ~722 KB more PSRAM than kBalanced
+};
+
+struct FramebufferProfileConfig
+{
+    const char *name;
+    int num_fbs;             // full frame buffers in PSRAM, RGB565 or 8-bit luminance
+    int bounce_buffer_lines; // per bounce buffer, the RGB driver allocates two in internal SRAM
+    int draw_buffer_lines;   // LVGL draw buffer height when rendering rotated bands, a multiple of 8
+    int num_draw_buffers;    // 2 lets LVGL render the next band while the previous one is rotated
+};
+
+inline const FramebufferProfileConfig &GetFramebufferProfile(FramebufferProfile profile)
+{
+    static constexpr FramebufferProfileConfig kProfiles[] = {
+        {"max-fps", 2, 20, 16, 2},
+        {"balanced", 2, 10, 16, 2},
+        {"min-memory", 1, 10, 8, 1},
+        {"triple", 3, 10, 16, 2},
+    };
+    return kProfiles[static_cast<int>(profile)];
+}
+
+// Buffer bytes a profile needs for a panel, everything else the driver and LVGL allocate comes on top
+struct FramebufferFootprint
+{
+    size_t psram_bytes;
+    size_t internal_bytes;
+};
+
+inline FramebufferFootprint GetFramebufferFootprint(const FramebufferProfileConfig &profile, int panel_width,
+                                                    int panel_height, bool rotated, bool mono = false)
+{
+    // Bounce buffers always hold RGB565, frame and draw buffers one byte per pixel when monochrome
+    const size_t bytes_per_pixel = mono ? 1 : 2;
+    FramebufferFootprint footprint;
+    footprint.psram_bytes = profile.num_fbs * panel_width * panel_height * bytes_per_pixel;
+    footprint.internal_bytes = 2 * profile.bounce_buffer_lines * panel_width * 2;
+    if (rotated)
+    {
+        // Bands span the rotated width, which is the panel height
+        footprint.internal_bytes += profile.num_draw_buffers * profile.draw_buffer_lines * panel_height * bytes_per_pixel;
+    }
+    return footprint;
+}
+
+#endif // FRAMEBUFFER_PROFILE_H
@@ -0,0 +1,199 @@
+#include "glyph_cache.h"
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <cstring>
+
+#define TAG "GlyphCache"
+
+const lv_font_t *GlyphCache::Wrap(const lv_font_t *font)
+{
+    if (font == nullptr)
+    {
+        return nullptr;
+    }
+    for (int i = 0; i < font_count_; i++)
+    {
+        if (&fonts_[i].font == font || fonts_[i].base == font)
+        {
+            return &fonts_[i].font;
+        }
+    }
+    if (font_count_ == kMaxFonts)
+    {
+        ESP_LOGW(TAG, "Too many fonts, drawing one uncached");
+        return font;
+    }
+
+    CachedFont &cached = fonts_[font_count_++];
+    cached.base = font;
+    cached.font = *font;
+    cached.font.get_glyph_bitmap = GetGlyphBitmap;
+    cached.font.fallback = Wrap(font->fallback);
+    return &cached.font;
+}
+
+const void *GlyphCache::GetGlyphBitmap(lv_font_glyph_dsc_t *g_dsc, lv_draw_buf_t *draw_buf)
+{
+    // Only wrappers point here, the font is always the first member of a CachedFont
+    auto *font = reinterpret_cast<const CachedFont *>(g_dsc->resolved_font);
+    return GetInstance().Lookup(*font, g_dsc, draw_buf);
+}
+
+const void *GlyphCache::Lookup(const CachedFont &font, lv_font_glyph_dsc_t *g_dsc, lv_draw_buf_t *draw_buf)
+{
+    auto decode = font.base->get_glyph_bitmap;
+    if (draw_buf == nullptr || g_dsc->format < LV_FONT_GLYPH_FORMAT_A1 || g_dsc->format > LV_FONT_GLYPH_FORMAT_A8)
+    {
+        bypassed_++;
+        return decode(g_dsc, draw_buf);
+    }
+
+    uint32_t glyph = g_dsc->gid.index;
+    Entry *entry = Find(&font.font, glyph);
+    if (entry != nullptr)
+    {
+        if (entry->stride == draw_buf->header.stride && entry->size <= draw_buf->data_size)
+        {
+            memcpy(draw_buf->data, entry->data, entry->size);
+            Touch(entry);
+            hits_++;
+            return draw_buf;
+        }
+        // The draw buffer layout changed under us, decode again
+        Remove(entry);
+    }
+
+    const void *bitmap = decode(g_dsc, draw_buf);
+    uint32_t size = draw_buf->header.stride * g_dsc->box_h;
+    // Fonts that return their own buffer instead of filling draw_buf are passed through
+    if (bitmap != draw_buf || size == 0 || size > draw_buf->data_size || sizeof(Entry) + size > capacity_)
+    {
+        bypassed_++;
+        return bitmap;
+    }
+    misses_++;
+    Insert(&font.font, glyph, draw_buf, size);
+    return bitmap;
+}
+
+uint32_t GlyphCache::Hash(const lv_font_t *font, uint32_t glyph)
+{
+    uint32_t h = (uint32_t)(uintptr_t)font ^ (glyph * 0x9E3779B1u);
+    return (h ^ (h >> 15)) & (kBuckets - 1);
+}
+
+GlyphCache::Entry *GlyphCache::Find(const lv_font_t *font, uint32_t glyph)
+{
+    for (Entry *entry = buckets_[Hash(font, glyph)]; entry != nullptr; entry = entry->bucket_next)
+    {
+        if (entry->font == font && entry->glyph == glyph)
+        {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+void GlyphCache::Insert(const lv_font_t *font, uint32_t glyph, const lv_draw_buf_t *draw_buf, uint32_t size)
+{
+    const size_t footprint = sizeof(Entry) + size;
+    while (lru_tail_ != nullptr && bytes_ + footprint > capacity_)
+    {
+        Remove(lru_tail_);
+        evictions_++;
+    }
+
+    auto *entry = static_cast<Entry *>(heap_caps_malloc(footprint, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (entry == nullptr)
+    {
+        entry = static_cast<Entry *>(heap_caps_malloc(footprint, MALLOC_CAP_DEFAULT));
+        if (entry == nullptr)
+        {
+            return;
+        }
+    }
+    entry->font = font;
+    entry->glyph = glyph;
+    entry->stride = draw_buf->header.stride;
+    entry->size = size;
+    memcpy(entry->data, draw_buf->data, size);
+
+    Entry *&bucket = buckets_[Hash(font, glyph)];
+    entry->bucket_next = bucket;
+    bucket = entry;
+    entry->prev = nullptr;
+    entry->next = lru_head_;
+    if (lru_head_ != nullptr)
+    {
+        lru_head_->prev = entry;
+    }
+    lru_head_ = entry;
+    if (lru_tail_ == nullptr)
+    {
+        lru_tail_ = entry;
+    }
+    bytes_ += footprint;
+    entries_++;
+}
+
+void GlyphCache::Remove(Entry *entry)
+{
+    for (Entry **link = &buckets_[Hash(entry->font, entry->glyph)]; *link != nullptr; link = &(*link)->bucket_next)
+    {
+        if (*link == entry)
+        {
+            *link = entry->bucket_next;
+            break;
+        }
+    }
+    (entry->prev != nullptr ? entry->prev->next : lru_head_) = entry->next;
+    (entry->next != nullptr ? entry->next->prev : lru_tail_) = entry->prev;
+    bytes_ -= sizeof(Entry) + entry->size;
+    entries_--;
+    heap_caps_free(entry);
+}
+
+void GlyphCache::Touch(Entry *entry)
+{
+    if (entry == lru_head_)
+    {
+        return;
+    }
+    entry->prev->next = entry->next;
+    (entry->next != nullptr ? entry->next->prev : lru_tail_) = entry->prev;
+    entry->prev = nullptr;
+    entry->next = lru_head_;
+    lru_head_->prev = entry;
+    lru_head_ = entry;
+}
+
+void GlyphCache::SetCapacity(size_t bytes)
+{
+    capacity_ = bytes;
+    while (lru_tail_ != nullptr && bytes_ > capacity_)
+    {
+        Remove(lru_tail_);
+        evictions_++;
+    }
+}
+
+void GlyphCache::Clear()
+{
+    while (lru_tail_ != nullptr)
+    {
+        Remove(lru_tail_);
+    }
+}
+
+GlyphCacheStats GlyphCache::GetStats() const
+{
+    GlyphCacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.bypassed = bypassed_;
+    stats.entries = entries_;
+    stats.bytes = bytes_;
+    stats.capacity_bytes = capacity_;
+    return stats;
+}
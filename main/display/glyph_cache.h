@@ -0,0 +1,89 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <lvgl.h>
+#include <cstddef>
+#include <cstdint>
+
+struct GlyphCacheStats
+{
+    uint32_t hits = 0;
+    uint32_t misses = 0;    // glyphs decoded by the font and then stored
+    uint32_t evictions = 0; // least recently used glyphs dropped to stay within the budget
+    uint32_t bypassed = 0;  // bitmaps the cache cannot hold, e.g. image glyphs or a full budget
+    uint32_t entries = 0;
+    uint32_t bytes = 0;
+    uint32_t capacity_bytes = 0;
+};
+
+// Size-bounded LRU cache of decoded glyph bitmaps. Compressed (and plain 1-4 bpp) LVGL fonts expand
+// every glyph into an A8 bitmap each time it is drawn; a wrapped font keeps those bitmaps, in PSRAM
+// when available, so redrawing the same labels costs a copy instead of a decode.
+// Only used from the LVGL task (LV_USE_OS is off), so there is no locking.
+class GlyphCache
+{
+public:
+    static GlyphCache &GetInstance()
+    {
+        static GlyphCache instance;
+        return instance;
+    }
+
+    // A font that renders exactly like font but goes through the cache. The fallback chain is
+    // wrapped too; wrapping the same font twice returns the same wrapper, nullptr stays nullptr.
+    const lv_font_t *Wrap(const lv_font_t *font);
+    // Shrinking evicts straight away
+    void SetCapacity(size_t bytes);
+    void Clear();
+    GlyphCacheStats GetStats() const;
+
+private:
+    static constexpr int kMaxFonts = 8;
+    static constexpr int kBuckets = 128; // power of two
+    static constexpr size_t kDefaultCapacity = 64 * 1024;
+
+    struct CachedFont
+    {
+        lv_font_t font; // first member, LVGL hands the wrapper back as resolved_font
+        const lv_font_t *base;
+    };
+
+    struct Entry
+    {
+        const lv_font_t *font;
+        uint32_t glyph;
+        uint32_t stride;
+        uint32_t size;
+        Entry *prev; // LRU list, most recently used first
+        Entry *next;
+        Entry *bucket_next;
+        uint8_t data[];
+    };
+
+    GlyphCache() = default;
+    GlyphCache(const GlyphCache &) = delete;
+    GlyphCache &operator=(const GlyphCache &) = delete;
+
+    CachedFont fonts_[kMaxFonts] = {};
+    int font_count_ = 0;
+    Entry *buckets_[kBuckets] = {};
+    Entry *lru_head_ = nullptr;
+    Entry *lru_tail_ = nullptr;
+    size_t capacity_ = kDefaultCapacity;
+    size_t bytes_ = 0;
+    uint32_t entries_ = 0;
+    uint32_t hits_ = 0;
+    uint32_t misses_ = 0;
+    uint32_t evictions_ = 0;
+    uint32_t bypassed_ = 0;
+
+    static const void *GetGlyphBitmap(lv_font_glyph_dsc_t *g_dsc, lv_draw_buf_t *draw_buf);
+    const void *Lookup(const CachedFont &font, lv_font_glyph_dsc_t *g_dsc, lv_draw_buf_t *draw_buf);
+    Entry *Find(const lv_font_t *font, uint32_t glyph);
+    void Insert(const lv_font_t *font, uint32_t glyph, const lv_draw_buf_t *draw_buf, uint32_t size);
+    void Remove(Entry *entry);
+    void Touch(Entry *entry);
+    static uint32_t Hash(const lv_font_t *font, uint32_t glyph);
+};
+
+#endif // GLYPH_CACHE_H
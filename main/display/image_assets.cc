@@ -0,0 +1,216 @@
+#include "image_assets.h"
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <cstring>
+
+#define TAG "ImageAssets"
+
+// Partition layout, little endian:
+//   AssetPackHeader, count x AssetEntry, then the image data, each image 4-byte aligned.
+//   Pixels are in LVGL orientation: RGB565, or ARGB8565 as RGB565 followed by an alpha byte.
+//   RLE images are (uint16_t run length, one pixel) records.
+struct AssetPackHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t total_size;
+    uint32_t reserved;
+};
+static_assert(sizeof(AssetPackHeader) == 16, "asset pack header is 16 bytes");
+
+struct AssetEntry
+{
+    char name[24];
+    uint16_t width;
+    uint16_t height;
+    uint8_t format;
+    uint8_t encoding;
+    uint16_t reserved;
+    uint32_t offset; // from the start of the partition
+    uint32_t size;
+};
+static_assert(sizeof(AssetEntry) == 40, "asset entry is 40 bytes");
+
+static constexpr uint32_t kAssetMagic = 0x31545341; // "AST1"
+static constexpr uint16_t kAssetVersion = 1;
+static constexpr uint8_t kFormatRgb565 = 0;
+static constexpr uint8_t kFormatArgb8565 = 1;
+static constexpr uint8_t kEncodingRaw = 0;
+static constexpr uint8_t kEncodingRle = 1;
+
+static uint32_t BytesPerPixel(uint8_t format)
+{
+    return format == kFormatArgb8565 ? 3 : 2;
+}
+
+static bool DecodeRle(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t pixels, uint32_t bpp)
+{
+    const uint8_t *end = src + size;
+    uint32_t pos = 0;
+    while (src + 2 + bpp <= end)
+    {
+        uint32_t length = src[0] | (src[1] << 8);
+        if (length == 0 || pos + length > pixels)
+        {
+            return false;
+        }
+        const uint8_t *pixel = src + 2;
+        uint8_t *out = dst + pos * bpp;
+        if (bpp == 2)
+        {
+            uint16_t color = pixel[0] | (pixel[1] << 8);
+            uint16_t *out16 = reinterpret_cast<uint16_t *>(out);
+            for (uint32_t i = 0; i < length; i++)
+            {
+                out16[i] = color;
+            }
+        }
+        else
+        {
+            for (uint32_t i = 0; i < length; i++)
+            {
+                memcpy(out + i * bpp, pixel, bpp);
+            }
+        }
+        pos += length;
+        src += 2 + bpp;
+    }
+    return pos == pixels;
+}
+
+ImageAssets::~ImageAssets()
+{
+    for (int i = 0; i < count_; i++)
+    {
+        if (images_[i].encoding != kEncodingRaw && images_[i].ready)
+        {
+            heap_caps_free(const_cast<uint8_t *>(images_[i].dsc.data));
+        }
+    }
+    delete[] images_;
+    if (mapped_ != nullptr)
+    {
+        esp_partition_munmap(mmap_handle_);
+    }
+}
+
+bool ImageAssets::Load()
+{
+    if (loaded_)
+    {
+        return mapped_ != nullptr;
+    }
+    loaded_ = true;
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                                IMAGE_ASSETS_PARTITION);
+    if (partition == nullptr)
+    {
+        ESP_LOGW(TAG, "No '%s' partition", IMAGE_ASSETS_PARTITION);
+        return false;
+    }
+
+    const void *mapped = nullptr;
+    if (esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &mapped, &mmap_handle_) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Failed to map '%s'", IMAGE_ASSETS_PARTITION);
+        return false;
+    }
+
+    AssetPackHeader header;
+    memcpy(&header, mapped, sizeof(header));
+    if (header.magic != kAssetMagic || header.version != kAssetVersion || header.total_size > partition->size ||
+        sizeof(header) + header.count * sizeof(AssetEntry) > header.total_size)
+    {
+        ESP_LOGW(TAG, "No image pack in '%s'", IMAGE_ASSETS_PARTITION);
+        esp_partition_munmap(mmap_handle_);
+        return false;
+    }
+    mapped_ = static_cast<const uint8_t *>(mapped);
+
+    const AssetEntry *entries = reinterpret_cast<const AssetEntry *>(mapped_ + sizeof(header));
+    images_ = new Image[header.count];
+    for (int i = 0; i < header.count; i++)
+    {
+        const AssetEntry &entry = entries[i];
+        uint32_t bpp = BytesPerPixel(entry.format);
+        if ((entry.format != kFormatRgb565 && entry.format != kFormatArgb8565) ||
+            entry.offset + entry.size > header.total_size || entry.name[sizeof(entry.name) - 1] != '\0' ||
+            (entry.encoding == kEncodingRaw && entry.size != entry.width * entry.height * bpp))
+        {
+            ESP_LOGW(TAG, "Skipping bad image entry %d", i);
+            continue;
+        }
+
+        Image &image = images_[count_++];
+        memset(&image, 0, sizeof(image));
+        image.name = entry.name;
+        image.data = mapped_ + entry.offset;
+        image.size = entry.size;
+        image.encoding = entry.encoding;
+        image.dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+        image.dsc.header.cf = entry.format == kFormatArgb8565 ? LV_COLOR_FORMAT_ARGB8565 : LV_COLOR_FORMAT_RGB565;
+        image.dsc.header.w = entry.width;
+        image.dsc.header.h = entry.height;
+        image.dsc.header.stride = entry.width * bpp;
+        image.dsc.data_size = entry.width * entry.height * bpp;
+    }
+
+    ESP_LOGI(TAG, "%d images in '%s' (%lu bytes)", count_, IMAGE_ASSETS_PARTITION, (unsigned long)header.total_size);
+    return true;
+}
+
+bool ImageAssets::Prepare(Image &image)
+{
+    if (image.encoding == kEncodingRaw)
+    {
+        // Zero copy: LVGL reads the pixels through the flash cache
+        image.dsc.data = image.data;
+        return true;
+    }
+    if (image.encoding != kEncodingRle)
+    {
+        ESP_LOGW(TAG, "Image %s has unknown encoding %u", image.name, image.encoding);
+        return false;
+    }
+
+    uint8_t *pixels = static_cast<uint8_t *>(heap_caps_malloc(image.dsc.data_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (pixels == nullptr)
+    {
+        ESP_LOGE(TAG, "No PSRAM for image %s (%lu bytes)", image.name, (unsigned long)image.dsc.data_size);
+        return false;
+    }
+    uint32_t bpp = image.dsc.header.stride / image.dsc.header.w;
+    if (!DecodeRle(image.data, image.size, pixels, image.dsc.header.w * image.dsc.header.h, bpp))
+    {
+        ESP_LOGW(TAG, "Corrupt image %s", image.name);
+        heap_caps_free(pixels);
+        return false;
+    }
+    image.dsc.data = pixels;
+    return true;
+}
+
+const lv_image_dsc_t *ImageAssets::Get(const char *name)
+{
+    if (!Load())
+    {
+        return nullptr;
+    }
+    for (int i = 0; i < count_; i++)
+    {
+        Image &image = images_[i];
+        if (strcmp(image.name, name) != 0)
+        {
+            continue;
+        }
+        if (!image.ready && !image.failed)
+        {
+            image.ready = Prepare(image);
+            image.failed = !image.ready;
+        }
+        return image.ready ? &image.dsc : nullptr;
+    }
+    return nullptr;
+}
@@ -0,0 +1,56 @@
+#ifndef IMAGE_ASSETS_H
+#define IMAGE_ASSETS_H
+
+#include <lvgl.h>
+#include <esp_partition.h>
+#include <cstdint>
+
+// Partition holding the packed UI images, written by tools/pack_assets.py
+#define IMAGE_ASSETS_PARTITION "assets"
+
+// Images packed into the assets partition. The partition is memory mapped once; uncompressed
+// images are handed to LVGL as descriptors pointing into the mapping, so they are drawn straight
+// from flash through the cache. RLE images are decoded into PSRAM the first time they are used.
+// Get must be called with the LVGL lock held, like any other LVGL call.
+class ImageAssets
+{
+public:
+    static ImageAssets &GetInstance()
+    {
+        static ImageAssets instance;
+        return instance;
+    }
+
+    // Maps the partition and reads the image table, safe to call more than once
+    bool Load();
+    // nullptr if the image is not in the pack or cannot be decoded
+    const lv_image_dsc_t *Get(const char *name);
+    int count() const { return count_; }
+
+private:
+    ImageAssets() = default;
+    ~ImageAssets();
+    ImageAssets(const ImageAssets &) = delete;
+    ImageAssets &operator=(const ImageAssets &) = delete;
+
+    struct Image
+    {
+        const char *name; // points into the mapping, NUL padded
+        lv_image_dsc_t dsc;
+        const uint8_t *data;
+        uint32_t size;
+        uint8_t encoding;
+        bool ready;
+        bool failed;
+    };
+
+    bool loaded_ = false;
+    const uint8_t *mapped_ = nullptr;
+    esp_partition_mmap_handle_t mmap_handle_ = 0;
+    Image *images_ = nullptr;
+    int count_ = 0;
+
+    bool Prepare(Image &image);
+};
+
+#endif // IMAGE_ASSETS_H
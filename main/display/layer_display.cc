@@ -0,0 +1,155 @@
+#include "layer_display.h"
+#include "rgb565_rotate.h"
+#include <esp_lvgl_port.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#define TAG "LayerDisplay"
+
+LayerDisplay::LayerDisplay(PanelScanout *scanout, int index, ScanoutLayerFormat format, int x, int y, int width,
+                           int height, int panel_width, int panel_height, bool mirror_x, bool mirror_y, bool swap_xy)
+    : scanout_(scanout), index_(index), mirror_x_(mirror_x), mirror_y_(mirror_y), swap_xy_(swap_xy)
+{
+    // Same mapping as RgbLcdDisplay::ToPanelArea
+    layer_.format = format;
+    if (swap_xy_)
+    {
+        layer_.x = mirror_x_ ? panel_width - y - height : y;
+        layer_.y = mirror_y_ ? panel_height - x - width : x;
+        layer_.width = height;
+        layer_.height = width;
+    }
+    else
+    {
+        if (mirror_x_ || mirror_y_)
+        {
+            ESP_LOGW(TAG, "Mirroring without swap_xy is not supported");
+        }
+        layer_.x = x;
+        layer_.y = y;
+        layer_.width = width;
+        layer_.height = height;
+    }
+
+    const size_t surface_bytes = static_cast<size_t>(width) * height * 4;
+    for (auto &surface : surfaces_)
+    {
+        surface = static_cast<uint32_t *>(heap_caps_aligned_calloc(16, 1, surface_bytes, MALLOC_CAP_SPIRAM));
+        assert(surface != nullptr);
+    }
+    const int draw_buffer_lines = std::clamp<int>(kDrawBufferBytes / (width * 4), 1, height);
+    const size_t draw_buffer_bytes = static_cast<size_t>(width) * draw_buffer_lines * 4;
+    draw_buffer_ = heap_caps_aligned_alloc(16, draw_buffer_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    assert(draw_buffer_ != nullptr);
+    footprint_.psram_bytes = 2 * surface_bytes;
+    footprint_.internal_bytes = draw_buffer_bytes;
+
+    lvgl_port_lock(0);
+    display_ = lv_display_create(width, height);
+    assert(display_ != nullptr);
+    const bool overlay = format == ScanoutLayerFormat::kArgb8888;
+    lv_display_set_color_format(display_, overlay ? LV_COLOR_FORMAT_ARGB8888 : LV_COLOR_FORMAT_XRGB8888);
+    lv_display_set_buffers(display_, draw_buffer_, nullptr, draw_buffer_bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_user_data(display_, this);
+    lv_display_set_flush_cb(display_, [](lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+                            { static_cast<LayerDisplay *>(lv_display_get_user_data(disp))->Flush(area, px_map); });
+    if (overlay)
+    {
+        // LVGL clears an alpha format to transparent before drawing, the screen must not cover it
+        lv_obj_set_style_bg_opa(screen(), LV_OPA_TRANSP, 0);
+    }
+    lvgl_port_unlock();
+
+    ESP_LOGI(TAG, "Layer %d (%s): %dx%d at %d,%d on the panel", index_, overlay ? "overlay" : "precision",
+             layer_.width, layer_.height, layer_.x, layer_.y);
+}
+
+LayerDisplay::~LayerDisplay()
+{
+    scanout_->SetLayer(index_, ScanoutLayer());
+    scanout_->WaitLayersLatched();
+    lvgl_port_lock(0);
+    lv_display_delete(display_);
+    lvgl_port_unlock();
+    heap_caps_free(draw_buffer_);
+    for (auto surface : surfaces_)
+    {
+        heap_caps_free(surface);
+    }
+}
+
+void LayerDisplay::SetVisible(bool visible)
+{
+    visible_ = visible;
+    if (!visible_)
+    {
+        scanout_->SetLayer(index_, ScanoutLayer());
+    }
+    else if (drawn_)
+    {
+        scanout_->SetLayer(index_, layer_);
+    }
+}
+
+void LayerDisplay::Flush(const lv_area_t *area, const uint8_t *px_map)
+{
+    uint32_t *back = surfaces_[back_];
+    if (!in_frame_)
+    {
+        // The back surface was on screen until the last change latched, and lacks what that
+        // change drew into the other one
+        scanout_->WaitLayersLatched();
+        const int first = last_frame_rows_[0];
+        const int last = last_frame_rows_[1];
+        if (first <= last)
+        {
+            const size_t offset = static_cast<size_t>(first) * layer_.width;
+            memcpy(back + offset, surfaces_[back_ ^ 1] + offset, static_cast<size_t>(last - first + 1) * layer_.width * 4);
+        }
+        frame_rows_[0] = layer_.height;
+        frame_rows_[1] = -1;
+        in_frame_ = true;
+    }
+
+    const auto *src = reinterpret_cast<const uint32_t *>(px_map);
+    const int w = lv_area_get_width(area);
+    const int h = lv_area_get_height(area);
+    int y;
+    int rows;
+    if (swap_xy_)
+    {
+        const int x = mirror_x_ ? layer_.width - 1 - area->y2 : area->y1;
+        y = mirror_y_ ? layer_.height - 1 - area->x2 : area->x1;
+        rows = w;
+        xrgb8888_rotate_swap_xy(src, w, h, w, back + y * layer_.width + x, layer_.width, mirror_x_, mirror_y_);
+    }
+    else
+    {
+        y = area->y1;
+        rows = h;
+        for (int row = 0; row < h; row++)
+        {
+            memcpy(back + (area->y1 + row) * layer_.width + area->x1, src + row * w, w * 4);
+        }
+    }
+    frame_rows_[0] = std::min(frame_rows_[0], y);
+    frame_rows_[1] = std::max(frame_rows_[1], y + rows - 1);
+
+    if (lv_display_flush_is_last(display_))
+    {
+        layer_.pixels = back;
+        drawn_ = true;
+        if (visible_)
+        {
+            scanout_->SetLayer(index_, layer_);
+        }
+        back_ ^= 1;
+        last_frame_rows_[0] = frame_rows_[0];
+        last_frame_rows_[1] = frame_rows_[1];
+        in_frame_ = false;
+    }
+    lv_display_flush_ready(display_);
+}
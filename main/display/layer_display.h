@@ -0,0 +1,61 @@
+#ifndef LAYER_DISPLAY_H
+#define LAYER_DISPLAY_H
+
+#include "panel_scanout.h"
+#include "framebuffer_profile.h"
+#include <lvgl.h>
+#include <cstdint>
+
+// A rectangle of the UI that LVGL renders on a display of its own into a PanelScanout layer,
+// composited over the frame buffer while the bounce buffers are filled:
+// - kXrgb8888, precision layers: 8 bits per channel, only dithered down to RGB565 on the way to
+//   the panel, so gradients do not band while the main render path keeps drawing 16 bits. Opaque,
+//   they hide what the main display draws in their rectangle.
+// - kArgb8888, overlays: a transparent screen with small, often changing content (status text)
+//   blended over the main display, which is never redrawn for them.
+//
+// Build the content on screen() under the LVGL lock. A change is drawn into a second surface that
+// replaces the first at a frame boundary: LVGL redraws only its dirty areas there, and the rows
+// the previous change drew are copied over from the surface on screen before it does.
+class LayerDisplay
+{
+public:
+    // x, y, width and height are LVGL coordinates of the main display; the panel position follows
+    // the same swap_xy and mirror mapping RgbLcdDisplay uses. index is the scan-out layer slot.
+    LayerDisplay(PanelScanout *scanout, int index, ScanoutLayerFormat format, int x, int y, int width, int height,
+                 int panel_width, int panel_height, bool mirror_x, bool mirror_y, bool swap_xy);
+    ~LayerDisplay();
+
+    lv_display_t *display() const { return display_; }
+    lv_obj_t *screen() const { return lv_display_get_screen_active(display_); }
+    // Shown from the first frame it has been drawn; hiding gives the rectangle back to the main display
+    void SetVisible(bool visible);
+    // Both surfaces in PSRAM, the draw buffer in internal RAM
+    FramebufferFootprint footprint() const { return footprint_; }
+
+private:
+    // Bands of the layer width, in internal RAM
+    static constexpr size_t kDrawBufferBytes = 16 * 1024;
+
+    PanelScanout *scanout_;
+    int index_;
+    bool mirror_x_;
+    bool mirror_y_;
+    bool swap_xy_;
+    ScanoutLayer layer_; // panel rectangle, pixels of the surface last drawn
+    uint32_t *surfaces_[2] = {nullptr, nullptr};
+    int back_ = 0;
+    bool drawn_ = false;
+    bool visible_ = true;
+    bool in_frame_ = false;
+    // Surface rows written by the frame being drawn and by the one before, first > last for none
+    int frame_rows_[2] = {0, -1};
+    int last_frame_rows_[2] = {0, -1};
+    void *draw_buffer_ = nullptr;
+    lv_display_t *display_ = nullptr;
+    FramebufferFootprint footprint_ = {};
+
+    void Flush(const lv_area_t *area, const uint8_t *px_map);
+};
+
+#endif // LAYER_DISPLAY_H
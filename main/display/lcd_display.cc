@@ -1,16 +1,31 @@
 #include "lcd_display.h"
-#include <vector>
+#include "rgb565_rotate.h"
+#include "layer_display.h"
+#include "glyph_cache.h"
+#include "stream_font.h"
+#include "band_scheduler.h"
+#include "framebuffer_dma.h"
+#include "boot_trace.h"
 #include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <esp_log.h>
 #include <esp_err.h>
 #include <esp_lvgl_port.h>
+#include <lvgl_private.h>
 #include <esp_heap_caps.h>
+#include <esp_lcd_panel_rgb.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include <freertos/task.h>
 
 #define TAG "LcdDisplay"
 
+
+// How often the frame timing summary is logged
+static constexpr int64_t kFrameStatsLogIntervalUs = 10 * 1000 * 1000;
+
 static SemaphoreHandle_t lvgl_mux = nullptr;
 
 LcdDisplay::LcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel, int width, int height)
@@ -24,10 +39,28 @@ LcdDisplay::LcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_
     {
         lvgl_mux = xSemaphoreCreateMutex();
     }
+
+    esp_timer_create_args_t frame_stats_timer_args = {
+        .callback = [](void *arg)
+        {
+            static_cast<LcdDisplay *>(arg)->LogFrameStats();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "frame_stats",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&frame_stats_timer_args, &frame_stats_timer_));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(frame_stats_timer_, kFrameStatsLogIntervalUs));
 }
 
 LcdDisplay::~LcdDisplay()
 {
+    if (frame_stats_timer_ != nullptr)
+    {
+        esp_timer_stop(frame_stats_timer_);
+        esp_timer_delete(frame_stats_timer_);
+    }
     if (notification_label_ != nullptr)
     {
         lv_obj_del(notification_label_);
@@ -53,10 +86,175 @@ void LcdDisplay::Unlock()
     }
 }
 
+void LcdDisplay::RecordFrame(uint32_t render_us, uint32_t flush_us, uint32_t vsync_wait_us)
+{
+    FrameSample sample = {esp_timer_get_time(), render_us, flush_us, vsync_wait_us};
+    portENTER_CRITICAL(&frame_stats_lock_);
+    frame_samples_[frame_count_ % kFrameStatsWindow] = sample;
+    frame_count_++;
+    portEXIT_CRITICAL(&frame_stats_lock_);
+}
+
+void LcdDisplay::RecordPresent(bool late, bool held)
+{
+    portENTER_CRITICAL(&frame_stats_lock_);
+    (late ? present_stats_.late : present_stats_.on_time)++;
+    present_stats_.held += held ? 1 : 0;
+    portEXIT_CRITICAL(&frame_stats_lock_);
+}
+
+void LcdDisplay::RecordDropped(uint32_t count)
+{
+    portENTER_CRITICAL(&frame_stats_lock_);
+    present_stats_.dropped += count;
+    portEXIT_CRITICAL(&frame_stats_lock_);
+}
+
+static void AddToHistogram(FrameTimeHistogram &histogram, uint32_t us, uint64_t &sum_us)
+{
+    int bucket = 0;
+    for (uint32_t ms = us / 1000; ms > 0 && bucket < FrameTimeHistogram::kBuckets - 1; ms >>= 1)
+    {
+        bucket++;
+    }
+    histogram.buckets[bucket]++;
+    histogram.max_us = std::max(histogram.max_us, us);
+    sum_us += us;
+}
+
+FrameStats LcdDisplay::GetFrameStats()
+{
+    FrameSample samples[kFrameStatsWindow];
+    FrameStats stats;
+    portENTER_CRITICAL(&frame_stats_lock_);
+    stats.frames = frame_count_;
+    stats.present = present_stats_;
+    stats.window = std::min<uint32_t>(frame_count_, kFrameStatsWindow);
+    memcpy(samples, frame_samples_, sizeof(samples));
+    portEXIT_CRITICAL(&frame_stats_lock_);
+    stats.panel_frames = panel_frames_.load(std::memory_order_relaxed);
+
+    if (stats.window == 0)
+    {
+        return stats;
+    }
+
+    uint64_t render_sum = 0;
+    uint64_t flush_sum = 0;
+    uint64_t vsync_wait_sum = 0;
+    int64_t first_present_us = INT64_MAX;
+    int64_t last_present_us = 0;
+    for (uint32_t i = 0; i < stats.window; i++)
+    {
+        const FrameSample &sample = samples[i];
+        AddToHistogram(stats.render, sample.render_us, render_sum);
+        AddToHistogram(stats.flush, sample.flush_us, flush_sum);
+        AddToHistogram(stats.vsync_wait, sample.vsync_wait_us, vsync_wait_sum);
+        first_present_us = std::min(first_present_us, sample.present_us);
+        last_present_us = std::max(last_present_us, sample.present_us);
+    }
+    stats.render.avg_us = render_sum / stats.window;
+    stats.flush.avg_us = flush_sum / stats.window;
+    stats.vsync_wait.avg_us = vsync_wait_sum / stats.window;
+    if (stats.window > 1 && last_present_us > first_present_us)
+    {
+        stats.fps = (stats.window - 1) * 1e6f / (last_present_us - first_present_us);
+    }
+    return stats;
+}
+
+void LcdDisplay::LogFrameStats()
+{
+    FrameStats stats = GetFrameStats();
+    int64_t now = esp_timer_get_time();
+    uint32_t frames = stats.frames - last_logged_frames_;
+    uint32_t panel_frames = stats.panel_frames - last_logged_panel_frames_;
+    float seconds = last_logged_us_ ? (now - last_logged_us_) / 1e6f : kFrameStatsLogIntervalUs / 1e6f;
+    last_logged_frames_ = stats.frames;
+    last_logged_panel_frames_ = stats.panel_frames;
+    last_logged_us_ = now;
+
+    // Nothing was drawn, keep quiet instead of repeating stale numbers
+    if (frames == 0)
+    {
+        return;
+    }
+
+    ESP_LOGI(TAG, "%lu frames in %.1f s, %.1f fps (panel %.1f Hz) | render avg %.1f max %.1f | flush avg %.1f max %.1f | "
+                  "vsync avg %.1f max %.1f ms",
+             (unsigned long)frames, seconds, stats.fps, panel_frames / seconds,
+             stats.render.avg_us / 1000.0f, stats.render.max_us / 1000.0f,
+             stats.flush.avg_us / 1000.0f, stats.flush.max_us / 1000.0f,
+             stats.vsync_wait.avg_us / 1000.0f, stats.vsync_wait.max_us / 1000.0f);
+    const PresentStats &p = stats.present;
+    ESP_LOGI(TAG, "present: %lu on time, %lu late, %lu dropped, %lu held back", (unsigned long)p.on_time,
+             (unsigned long)p.late, (unsigned long)p.dropped, (unsigned long)p.held);
+    ESP_LOGD(TAG, "render ms <1:%u <2:%u <4:%u <8:%u <16:%u <32:%u <64:%u >=64:%u",
+             stats.render.buckets[0], stats.render.buckets[1], stats.render.buckets[2], stats.render.buckets[3],
+             stats.render.buckets[4], stats.render.buckets[5], stats.render.buckets[6], stats.render.buckets[7]);
+
+    UiQueueStats ui = ui_queue_.GetStats();
+    if (ui.posted > 0 || ui.dropped > 0)
+    {
+        ESP_LOGI(TAG, "ui queue: %lu posted, %lu drained, %lu coalesced, %lu dropped, depth max %lu, latency avg %.1f max %.1f ms, "
+                      "to photon avg %.1f max %.1f ms",
+                 (unsigned long)ui.posted, (unsigned long)ui.drained, (unsigned long)ui.coalesced,
+                 (unsigned long)ui.dropped, (unsigned long)ui.high_water,
+                 ui.avg_latency_us / 1000.0f, ui.max_latency_us / 1000.0f,
+                 ui.avg_photon_us / 1000.0f, ui.max_photon_us / 1000.0f);
+    }
+    GlyphCacheStats glyphs = GlyphCache::GetInstance().GetStats();
+    if (glyphs.hits + glyphs.misses > 0)
+    {
+        ESP_LOGI(TAG, "glyph cache: %lu hits, %lu misses, %lu evictions, %lu bypassed, %lu glyphs in %lu/%lu KB",
+                 (unsigned long)glyphs.hits, (unsigned long)glyphs.misses, (unsigned long)glyphs.evictions,
+                 (unsigned long)glyphs.bypassed, (unsigned long)glyphs.entries,
+                 (unsigned long)glyphs.bytes / 1024, (unsigned long)glyphs.capacity_bytes / 1024);
+    }
+    StreamFontStats cjk = StreamFont::GetInstance().GetStats();
+    if (cjk.lookups > 0)
+    {
+        ESP_LOGI(TAG, "font partition: %lu lookups, index cache %lu hits %lu misses, %lu bitmaps read",
+                 (unsigned long)cjk.lookups, (unsigned long)cjk.index_hits, (unsigned long)cjk.index_misses,
+                 (unsigned long)cjk.bitmaps);
+    }
+    BandStats bands = BandScheduler::GetInstance().GetStats();
+    if (bands.split_jobs > 0)
+    {
+        ESP_LOGI(TAG, "bands: %lu jobs, %lu on both cores | core 0 %.1f ms in %lu bands, core 1 %.1f ms in %lu bands | "
+                      "speedup x%.2f",
+                 (unsigned long)bands.jobs, (unsigned long)bands.split_jobs,
+                 bands.busy_us[0] / 1000.0f, (unsigned long)bands.bands[0],
+                 bands.busy_us[1] / 1000.0f, (unsigned long)bands.bands[1],
+                 bands.split_wall_us > 0 ? (float)bands.split_busy_us / bands.split_wall_us : 1.0f);
+    }
+    LogPanelStats();
+    FramebufferDmaStats dma = FramebufferDma::GetInstance().GetStats();
+    if (dma.transfers > 0)
+    {
+        ESP_LOGI(TAG, "fb dma: %lu transfers, %lu KB | %lu copies by the CPU, %lu KB | fence waited %lu times, %.1f ms",
+                 (unsigned long)dma.transfers, (unsigned long)(dma.dma_bytes / 1024),
+                 (unsigned long)dma.cpu_copies, (unsigned long)(dma.cpu_bytes / 1024),
+                 (unsigned long)dma.fence_waits, dma.fence_wait_us / 1000.0f);
+    }
+    PmActivityLock::LogSummary();
+}
+
 void LcdDisplay::SetupUI()
 {
     ESP_LOGI(TAG, "Setting up basic UI components");
 
+    // Labels inherit the screen font. CJK text comes from the font partition when one was flashed,
+    // with the built-in font as fallback, and either way goes through the decoded glyph cache.
+    lv_obj_t *screen = lv_screen_active();
+    const lv_font_t *font = lv_obj_get_style_text_font(screen, LV_PART_MAIN);
+    auto &stream_font = StreamFont::GetInstance();
+    if (stream_font.Load(font))
+    {
+        font = stream_font.font();
+    }
+    lv_obj_set_style_text_font(screen, GlyphCache::GetInstance().Wrap(font), 0);
+
     // Create status label in the top center
     status_label_ = lv_label_create(lv_screen_active());
     if (status_label_)
@@ -96,19 +294,23 @@ void LcdDisplay::SetupUI()
 // RGB LCD实现
 RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                              int width, int height, int offset_x, int offset_y,
-                             bool mirror_x, bool mirror_y, bool swap_xy)
-    : LcdDisplay(panel_io, panel, width, height)
+                             bool mirror_x, bool mirror_y, bool swap_xy,
+                             RgbRefreshMode refresh_mode, const FramebufferProfileConfig &profile,
+                             PanelScanout *scanout)
+    : LcdDisplay(panel_io, panel, swap_xy ? height : width, swap_xy ? width : height),
+      refresh_mode_(refresh_mode), scanout_(scanout), panel_width_(width), panel_height_(height),
+      mirror_x_(mirror_x), mirror_y_(mirror_y), swap_xy_(swap_xy),
+      num_fbs_(profile.num_fbs), draw_buffer_lines_(profile.draw_buffer_lines),
+      num_draw_buffers_(profile.num_draw_buffers)
 {
 
-    ESP_LOGI(TAG, "Initializing RGB LCD Display %dx%d", width, height);
-
-    // draw white background first
-    std::vector<uint16_t> buffer(width_, 0xFFFF);
-    for (int y = 0; y < height_; y++)
-    {
-        esp_lcd_panel_draw_bitmap(panel_, 0, y, width_, y + 1, buffer.data());
-    }
+    ESP_LOGI(TAG, "Initializing RGB LCD Display %dx%d (%s refresh%s, %s profile)", width_, height_,
+             refresh_mode_ == RgbRefreshMode::kDirtyRect ? "dirty-rect" : "full",
+             swap_xy_ ? ", rotated in flush" : "", profile.name);
 
+    // The board has already put the boot splash into the frame buffer being scanned out
+    auto &trace = BootTrace::GetInstance();
+    trace.Begin(BootPhase::kLvglInit);
     ESP_LOGI(TAG, "Initialize LVGL library");
     lv_init();
 
@@ -116,50 +318,996 @@ RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
     lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
     port_cfg.task_priority = 4;
     port_cfg.timer_period_ms = 20; // Further increase timer period to reduce load
+    // With the band helper running, LVGL gets the other core to itself
+    int helper_core = BandScheduler::GetInstance().helper_core();
+    if (helper_core >= 0)
+    {
+        port_cfg.task_affinity = helper_core ^ 1;
+    }
     ESP_ERROR_CHECK(lvgl_port_init(&port_cfg));
+    trace.End(BootPhase::kLvglInit);
 
-    ESP_LOGI(TAG, "Adding RGB LCD display to LVGL");
-    const lvgl_port_display_cfg_t display_cfg = {
-        .io_handle = panel_io_,
-        .panel_handle = panel_,
-        .buffer_size = static_cast<uint32_t>(width_ * 10), // Further reduce buffer size
-        .double_buffer = true,
-        .hres = static_cast<uint32_t>(width_),
-        .vres = static_cast<uint32_t>(height_),
-        .rotation = {
-            .swap_xy = swap_xy,
-            .mirror_x = mirror_x,
-            .mirror_y = mirror_y,
-        },
-        .flags = {
-            .buff_dma = 1,
-            .swap_bytes = 0,
-            .full_refresh = 1,
-            .direct_mode = 1,
-        },
-    };
+    void *fb0 = nullptr;
+    void *fb1 = nullptr;
+    void *fb2 = nullptr;
+    if (num_fbs_ > 2 && !swap_xy_)
+    {
+        // LVGL's direct mode swaps between two buffers of its own choosing
+        ESP_LOGW(TAG, "Three frame buffers need the rotated path, presenting from two");
+        num_fbs_ = 2;
+    }
+    if (scanout_ != nullptr)
+    {
+        bytes_per_pixel_ = scanout_->bytes_per_pixel();
+        num_fbs_ = std::min(num_fbs_, scanout_->num_frame_buffers());
+        fb0 = scanout_->frame_buffer(0);
+        fb1 = num_fbs_ > 1 ? scanout_->frame_buffer(1) : nullptr;
+        fb2 = num_fbs_ > 2 ? scanout_->frame_buffer(2) : nullptr;
+        if (num_fbs_ == 1)
+        {
+            back_buffer_ = 0;
+        }
+    }
+    else if (num_fbs_ > 2)
+    {
+        ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_, 3, &fb0, &fb1, &fb2));
+    }
+    else if (num_fbs_ > 1)
+    {
+        ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_, 2, &fb0, &fb1));
+    }
+    else
+    {
+        ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_, 1, &fb0));
+        back_buffer_ = 0;
+    }
+    frame_buffers_[0] = static_cast<uint8_t *>(fb0);
+    frame_buffers_[1] = static_cast<uint8_t *>(fb1 != nullptr ? fb1 : fb0);
+    frame_buffers_[2] = static_cast<uint8_t *>(fb2);
 
-    const lvgl_port_display_rgb_cfg_t rgb_cfg = {
-        .flags = {
-            .bb_mode = true,
-            .avoid_tearing = true,
-        }};
+    // The panel runs in bounce buffer mode, so a frame buffer switch requested with
+    // draw_bitmap takes effect once the bounce buffers finished the current frame. The scan-out
+    // stage owns the panel's callbacks when there is one and reports the same moment.
+    if (scanout_ != nullptr)
+    {
+        scanout_->SetFrameDoneCallback([](void *ctx) -> bool
+                                       { return static_cast<RgbLcdDisplay *>(ctx)->OnPanelFrameDone(); }, this);
+    }
+    else
+    {
+        const esp_lcd_rgb_panel_event_callbacks_t callbacks = {
+            .on_bounce_frame_finish = [](esp_lcd_panel_handle_t, const esp_lcd_rgb_panel_event_data_t *,
+                                         void *user_ctx) -> bool
+            { return static_cast<RgbLcdDisplay *>(user_ctx)->OnPanelFrameDone(); },
+        };
+        ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel_, &callbacks, this));
+    }
 
-    display_ = lvgl_port_add_disp_rgb(&display_cfg, &rgb_cfg);
+    ESP_LOGI(TAG, "Adding RGB LCD display to LVGL");
+    trace.Begin(BootPhase::kDisplayAdd);
+    lvgl_port_lock(0);
+    display_ = lv_display_create(width_, height_);
     if (display_ == nullptr)
     {
+        lvgl_port_unlock();
         ESP_LOGE(TAG, "Failed to add RGB display to LVGL");
         return;
     }
+    // Monochrome frame buffers take LVGL's luminance output, tinted at scan-out
+    lv_display_set_color_format(display_, bytes_per_pixel_ == 1 ? LV_COLOR_FORMAT_L8 : LV_COLOR_FORMAT_RGB565);
+    lv_display_set_user_data(display_, this);
+    lv_display_set_flush_cb(display_, [](lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+                            { static_cast<RgbLcdDisplay *>(lv_display_get_user_data(disp))->Flush(area, px_map); });
+    // Apply queued status/notification updates before this frame's areas are collected
+    lv_display_add_event_cb(display_, [](lv_event_t *e)
+                            { static_cast<RgbLcdDisplay *>(lv_event_get_user_data(e))->ProcessUiCommands(); },
+                            LV_EVENT_REFR_START, this);
+    // LVGL pauses its refresh timer while nothing is invalid, so on a static screen REFR_START does
+    // not come. This timer is never paused and drains the queue itself; the label changes it
+    // applies invalidate, which resumes the refresh.
+    ui_drain_timer_ = lv_timer_create([](lv_timer_t *timer)
+                                      { static_cast<RgbLcdDisplay *>(lv_timer_get_user_data(timer))->ProcessUiCommands(); },
+                                      kUiDrainPeriodMs, this);
+
+    const uint32_t frame_bytes = panel_width_ * panel_height_ * bytes_per_pixel_;
+    if (!swap_xy_)
+    {
+        // LVGL draws straight into the panel frame buffers
+        if (mirror_x_ || mirror_y_)
+        {
+            ESP_LOGW(TAG, "Mirroring without swap_xy is not supported when rendering into the frame buffers");
+        }
+        lv_display_set_buffers(display_, fb0, fb1, frame_bytes,
+                               refresh_mode_ == RgbRefreshMode::kFullRefresh ? LV_DISPLAY_RENDER_MODE_FULL
+                                                                             : LV_DISPLAY_RENDER_MODE_DIRECT);
+    }
+    else
+    {
+        // LVGL renders landscape bands into internal RAM and Flush rotates them into the back frame buffer
+        const size_t draw_buffer_bytes = width_ * draw_buffer_lines_ * bytes_per_pixel_;
+        for (int i = 0; i < num_draw_buffers_; i++)
+        {
+            draw_buffers_[i] = heap_caps_aligned_alloc(16, draw_buffer_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            assert(draw_buffers_[i] != nullptr);
+        }
+        lv_display_set_buffers(display_, draw_buffers_[0], draw_buffers_[1], draw_buffer_bytes,
+                               LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+        // Keep areas on 8 pixel boundaries so every band rotates as whole aligned 8x8 blocks
+        lv_display_add_event_cb(display_, [](lv_event_t *e)
+                                {
+                                    auto area = static_cast<lv_area_t *>(lv_event_get_param(e));
+                                    area->x1 &= ~7;
+                                    area->y1 &= ~7;
+                                    area->x2 |= 7;
+                                    area->y2 |= 7; },
+                                LV_EVENT_INVALIDATE_AREA, nullptr);
+
+        if (refresh_mode_ == RgbRefreshMode::kFullRefresh)
+        {
+            lv_display_add_event_cb(display_, [](lv_event_t *e)
+                                    {
+                                        auto disp = static_cast<lv_display_t *>(lv_event_get_current_target(e));
+                                        if (disp->inv_p > 0)
+                                        {
+                                            lv_area_t full;
+                                            lv_area_set(&full, 0, 0, lv_display_get_horizontal_resolution(disp) - 1,
+                                                        lv_display_get_vertical_resolution(disp) - 1);
+                                            lv_inv_area(disp, &full);
+                                        } },
+                                    LV_EVENT_REFR_START, nullptr);
+        }
+    }
 
     if (offset_x != 0 || offset_y != 0)
     {
         lv_display_set_offset(display_, offset_x, offset_y);
     }
 
+    lv_display_add_event_cb(display_, [](lv_event_t *e)
+                            { static_cast<RgbLcdDisplay *>(lv_event_get_user_data(e))->OnRenderStart(); },
+                            LV_EVENT_RENDER_START, this);
+    lv_display_add_event_cb(display_, [](lv_event_t *e)
+                            { static_cast<RgbLcdDisplay *>(lv_event_get_user_data(e))->pm_lock_.Release(); },
+                            LV_EVENT_RENDER_READY, this);
+    // UI commands that changed nothing on screen are not waiting for a frame any more
+    lv_display_add_event_cb(display_, [](lv_event_t *e)
+                            { static_cast<RgbLcdDisplay *>(lv_event_get_user_data(e))->DropUnpresented(); },
+                            LV_EVENT_REFR_READY, this);
+    lvgl_port_unlock();
+    trace.End(BootPhase::kDisplayAdd);
+
     ESP_LOGI(TAG, "Setting up basic UI");
     // Setup the basic UI first - styles are now set immediately during creation
+    trace.Begin(BootPhase::kSetupUi);
     SetupUI();
+    trace.End(BootPhase::kSetupUi);
 
     ESP_LOGI(TAG, "RGB LCD display initialization complete");
-}
\ No newline at end of file
+}
+
+RgbLcdDisplay::~RgbLcdDisplay()
+{
+    for (auto layer : layers_)
+    {
+        delete layer;
+    }
+    if (display_ != nullptr)
+    {
+        lvgl_port_lock(0);
+        if (ui_drain_timer_ != nullptr)
+        {
+            lv_timer_delete(ui_drain_timer_);
+        }
+        lv_display_delete(display_);
+        lvgl_port_unlock();
+    }
+    for (auto draw_buffer : draw_buffers_)
+    {
+        heap_caps_free(draw_buffer);
+    }
+}
+
+bool RgbLcdDisplay::OnPanelFrameDone()
+{
+    RecordPanelFrame();
+    // The buffer handed over last has just been latched
+    portENTER_CRITICAL_ISR(&present_lock_);
+    if (pending_buffer_ >= 0)
+    {
+        scanout_buffer_ = pending_buffer_;
+        pending_buffer_ = -1;
+    }
+    portEXIT_CRITICAL_ISR(&present_lock_);
+    // Wake the flush waiting for this buffer switch, or the render task when a refresh is due
+    BaseType_t need_yield = pdFALSE;
+    TaskHandle_t task = render_task_ != nullptr ? render_task_ : flush_task_;
+    if (task != nullptr && (waiting_for_vsync_.load(std::memory_order_relaxed) ||
+                            refresh_requested_.load(std::memory_order_relaxed)))
+    {
+        vTaskNotifyGiveFromISR(task, &need_yield);
+    }
+    return need_yield == pdTRUE;
+}
+
+void RgbLcdDisplay::HandOverFrame(void *frame)
+{
+    if (scanout_ != nullptr)
+    {
+        if (ring_height_ > 0)
+        {
+            // Mirrored, the band's first UI row is the window's last column
+            const int offset = mirror_x_ ? (ring_height_ - ring_scroll_) % ring_height_ : ring_scroll_;
+            for (int i = 0; i < num_fbs_; i++)
+            {
+                if (frame == frame_buffers_[i])
+                {
+                    scanout_->SetRingOffset(i, offset);
+                }
+            }
+        }
+        scanout_->Present(frame);
+    }
+    else
+    {
+        esp_lcd_panel_draw_bitmap(panel_, 0, 0, panel_width_, panel_height_, frame);
+    }
+}
+
+void RgbLcdDisplay::Flush(const lv_area_t *area, uint8_t *px_map)
+{
+    int64_t start_us = esp_timer_get_time();
+    flush_task_ = xTaskGetCurrentTaskHandle();
+
+    if (swap_xy_)
+    {
+        // The last frame's sync into this buffer must land before anything is drawn over it
+        if (sync_in_flight_)
+        {
+            FramebufferDma::GetInstance().Wait();
+            sync_in_flight_ = false;
+        }
+        if (ring_height_ > 0)
+        {
+            RotateThroughRing(area, px_map);
+        }
+        else
+        {
+            RotateIntoBackBuffer(area, px_map);
+        }
+    }
+
+    if (lv_display_flush_is_last(display_))
+    {
+        // In direct and full mode px_map is the frame buffer LVGL just finished
+        void *frame = swap_xy_ ? static_cast<void *>(frame_buffers_[back_buffer_]) : px_map;
+        const int drawn = back_buffer_;
+        int64_t wait_us = PresentFrame(frame);
+        // Queued frames latch at the next vsync, this is when the panel got the frame
+        RecordPresented(esp_timer_get_time());
+        frame_presented_ = true;
+        if (swap_xy_ && num_fbs_ > 1)
+        {
+            buffer_frames_[drawn] = frame_seq_;
+            SyncBackBuffer(drawn);
+            frame_seq_++;
+        }
+        // The next frame starts a fresh dirty list (drawn in place, this one is simply dropped)
+        frame_areas_[frame_seq_ % kAreaHistory].count = 0;
+        BootTrace::GetInstance().Mark(BootPhase::kFirstFrame);
+
+        int64_t end_us = esp_timer_get_time();
+        frame_vsync_wait_us_ += wait_us;
+        frame_flush_us_ += (end_us - start_us) - wait_us;
+        uint32_t frame_us = end_us - render_start_us_;
+        RecordFrame(frame_us - frame_flush_us_ - frame_vsync_wait_us_, frame_flush_us_, frame_vsync_wait_us_);
+        lv_display_flush_ready(display_);
+        return;
+    }
+
+    frame_flush_us_ += esp_timer_get_time() - start_us;
+    lv_display_flush_ready(display_);
+}
+
+lv_area_t RgbLcdDisplay::ToPanelArea(const lv_area_t *area) const
+{
+    // Same mapping as esp_lcd: swap the axes first, then mirror in panel space
+    lv_area_t panel_area;
+    panel_area.x1 = mirror_x_ ? panel_width_ - 1 - area->y2 : area->y1;
+    panel_area.y1 = mirror_y_ ? panel_height_ - 1 - area->x2 : area->x1;
+    panel_area.x2 = panel_area.x1 + lv_area_get_height(area) - 1;
+    panel_area.y2 = panel_area.y1 + lv_area_get_width(area) - 1;
+    return panel_area;
+}
+
+void RgbLcdDisplay::RotateIntoBackBuffer(const lv_area_t *area, const uint8_t *px_map)
+{
+    // Source columns become panel rows, so column bands can be rotated on both cores without
+    // sharing a destination row
+    struct RotateJob
+    {
+        RgbLcdDisplay *display;
+        const lv_area_t *area;
+        const uint8_t *src;
+    };
+    RotateJob job = {this, area, px_map};
+    BandScheduler::GetInstance().Run(lv_area_get_width(area), kRotateBandColumns, [](void *ctx, int first, int end)
+    {
+        const auto &job = *static_cast<const RotateJob *>(ctx);
+        lv_area_t columns = *job.area;
+        columns.x1 = job.area->x1 + first;
+        columns.x2 = job.area->x1 + end - 1;
+        lv_area_t panel_area = job.display->ToPanelArea(&columns);
+        const uint32_t bpp = job.display->bytes_per_pixel_;
+        uint8_t *dst = job.display->frame_buffers_[job.display->back_buffer_] +
+                       (panel_area.y1 * job.display->panel_width_ + panel_area.x1) * bpp;
+        if (bpp == 1)
+        {
+            l8_rotate_swap_xy(job.src + first, end - first, lv_area_get_height(job.area),
+                              lv_area_get_width(job.area), dst, job.display->panel_width_,
+                              job.display->mirror_x_, job.display->mirror_y_);
+        }
+        else
+        {
+            rgb565_rotate_swap_xy(reinterpret_cast<const uint16_t *>(job.src) + first, end - first,
+                                  lv_area_get_height(job.area), lv_area_get_width(job.area),
+                                  reinterpret_cast<uint16_t *>(dst), job.display->panel_width_,
+                                  job.display->mirror_x_, job.display->mirror_y_);
+        }
+    }, &job);
+
+    FrameAreas &frame_areas = frame_areas_[frame_seq_ % kAreaHistory];
+    if (frame_areas.count < kMaxFrameAreas)
+    {
+        frame_areas.areas[frame_areas.count] = ToPanelArea(area);
+    }
+    frame_areas.count++;
+}
+
+void RgbLcdDisplay::RotateThroughRing(const lv_area_t *area, const uint8_t *px_map)
+{
+    // Runs of rows that stay contiguous in storage: rows around the band as they are, rows inside
+    // it split where the ring wraps
+    const size_t row_bytes = lv_area_get_width(area) * bytes_per_pixel_;
+    const int ring_end = ring_y_ + ring_height_;
+    int y = area->y1;
+    while (y <= area->y2)
+    {
+        lv_area_t rows = *area;
+        if (y < ring_y_)
+        {
+            rows.y1 = y;
+            rows.y2 = std::min<int>(area->y2, ring_y_ - 1);
+        }
+        else if (y >= ring_end)
+        {
+            rows.y1 = y;
+        }
+        else
+        {
+            const int stored = ring_y_ + (y - ring_y_ + ring_scroll_) % ring_height_;
+            const int count = std::min(std::min<int>(area->y2 + 1, ring_end) - y, ring_end - stored);
+            rows.y1 = stored;
+            rows.y2 = stored + count - 1;
+        }
+        RotateIntoBackBuffer(&rows, px_map + (y - area->y1) * row_bytes);
+        y += lv_area_get_height(&rows);
+    }
+}
+
+int64_t RgbLcdDisplay::PresentFrame(void *frame)
+{
+    int64_t start_us = esp_timer_get_time();
+    bool held = false;
+    bool replaced = false;
+    bool late = false;
+
+    if (num_fbs_ > 2)
+    {
+        // Present queue: one buffer scanned out, at most one handed over and waiting to latch,
+        // the third free for the next frame. An early frame is held until its predecessor is on
+        // screen and its pacing slot has come; a late one goes out at once and takes the place of
+        // a predecessor still waiting, which is then never shown.
+        for (;;)
+        {
+            const uint32_t vsync = panel_frames();
+            late = static_cast<int32_t>(vsync - frame_deadline_) >= 0;
+            portENTER_CRITICAL(&present_lock_);
+            const bool queued = pending_buffer_ >= 0;
+            portEXIT_CRITICAL(&present_lock_);
+            if (late || (!queued && static_cast<int32_t>(vsync + 1 - frame_deadline_) >= 0))
+            {
+                break;
+            }
+            WaitForVsync();
+            held = true;
+        }
+        HandOverFrame(frame);
+
+        portENTER_CRITICAL(&present_lock_);
+        replaced = pending_buffer_ >= 0;
+        pending_buffer_ = back_buffer_;
+        // Draw next into the free buffer with the newest content, the least to bring up to date
+        int next = -1;
+        for (int i = 0; i < num_fbs_; i++)
+        {
+            if (i != scanout_buffer_ && i != pending_buffer_ &&
+                (next < 0 || static_cast<int32_t>(buffer_frames_[i] - buffer_frames_[next]) > 0))
+            {
+                next = i;
+            }
+        }
+        back_buffer_ = next;
+        portEXIT_CRITICAL(&present_lock_);
+        PaceFrames(late);
+    }
+    else
+    {
+        late = static_cast<int32_t>(panel_frames() - frame_deadline_) >= 0;
+        HandOverFrame(frame);
+        if (num_fbs_ > 1)
+        {
+            portENTER_CRITICAL(&present_lock_);
+            pending_buffer_ = back_buffer_;
+            portEXIT_CRITICAL(&present_lock_);
+            WaitForVsync();
+            back_buffer_ ^= 1;
+        }
+    }
+
+    RecordPresent(late, held);
+    if (replaced)
+    {
+        RecordDropped(1);
+    }
+    prev_frame_late_ = late;
+    return num_fbs_ > 1 ? esp_timer_get_time() - start_us : 0;
+}
+
+void RgbLcdDisplay::PaceFrames(bool late)
+{
+    // Several late frames in a row: present every other vsync instead, a steady half rate looks
+    // smoother than frames alternating between one and two vsyncs. Back to full rate once frames
+    // have fit in one vsync for a while.
+    late_history_ = (late_history_ << 1) | (late ? 1 : 0);
+    const bool fit_one_vsync = static_cast<int32_t>(panel_frames() - render_start_vsync_) <= 0;
+    if (pace_vsyncs_ == 1 && __builtin_popcount(late_history_ & 0xFF) >= kLateFramesForHalfRate)
+    {
+        pace_vsyncs_ = 2;
+        fast_frames_ = 0;
+        ESP_LOGI(TAG, "Frames are late, pacing to every other vsync");
+    }
+    else if (pace_vsyncs_ == 2)
+    {
+        fast_frames_ = fit_one_vsync ? fast_frames_ + 1 : 0;
+        if (fast_frames_ >= kFastFramesForFullRate)
+        {
+            pace_vsyncs_ = 1;
+            late_history_ = 0;
+            ESP_LOGI(TAG, "Frames fit one vsync again, pacing to every vsync");
+        }
+    }
+}
+
+void RgbLcdDisplay::SyncBackBuffer(int source)
+{
+    // The new back buffer still shows an older frame: copy in the areas drawn since then from
+    // the buffer just finished. Full refresh redraws everything anyway.
+    const uint32_t newest = buffer_frames_[source];
+    const uint32_t have = buffer_frames_[back_buffer_];
+    buffer_frames_[back_buffer_] = newest;
+    if (refresh_mode_ == RgbRefreshMode::kFullRefresh || have == newest)
+    {
+        return;
+    }
+
+    // Rows of an area are copied in bands on both cores
+    struct SyncJob
+    {
+        const uint8_t *front;
+        uint8_t *back;
+        size_t row_bytes; // panel row
+        size_t x1;
+        size_t y1;
+        size_t copy_bytes;
+    };
+    auto copy_rows = [](void *ctx, int first, int end)
+    {
+        const auto &job = *static_cast<const SyncJob *>(ctx);
+        for (int y = first; y < end; y++)
+        {
+            const size_t offset = (job.y1 + y) * job.row_bytes + job.x1;
+            memcpy(job.back + offset, job.front + offset, job.copy_bytes);
+        }
+    };
+    auto &scheduler = BandScheduler::GetInstance();
+
+    const uint8_t *front = frame_buffers_[source];
+    uint8_t *back = frame_buffers_[back_buffer_];
+    bool whole_frame = newest - have > kAreaHistory;
+    for (uint32_t seq = have + 1; !whole_frame && seq != newest + 1; seq++)
+    {
+        whole_frame = frame_areas_[seq % kAreaHistory].count > kMaxFrameAreas;
+    }
+
+    // Areas that span at least half the panel width go to the copy engine as whole rows, which are
+    // contiguous: a few more bytes, no CPU time. Narrower ones are copied by the CPU right away, before
+    // any transfer into the same buffer is queued (see framebuffer_dma.h).
+    auto &dma = FramebufferDma::GetInstance();
+    const size_t row_bytes_full = (size_t)panel_width_ * bytes_per_pixel_;
+    struct RowSpan
+    {
+        int y1;
+        int y2;
+    };
+    RowSpan spans[kMaxFrameAreas * kAreaHistory];
+    int span_count = 0;
+
+    uint32_t synced_bytes = 0;
+    if (whole_frame && dma.started())
+    {
+        spans[span_count++] = {0, panel_height_ - 1};
+    }
+    else if (whole_frame)
+    {
+        // As one panel-wide area
+        SyncJob job = {front, back, row_bytes_full, 0, 0, row_bytes_full};
+        scheduler.Run(panel_height_, std::max<int>(1, kSyncBandBytes / job.copy_bytes), copy_rows, &job);
+        synced_bytes = panel_width_ * panel_height_ * bytes_per_pixel_;
+    }
+    else
+    {
+        for (uint32_t seq = have + 1; seq != newest + 1; seq++)
+        {
+            const FrameAreas &frame_areas = frame_areas_[seq % kAreaHistory];
+            for (int i = 0; i < frame_areas.count; i++)
+            {
+                const lv_area_t &area = frame_areas.areas[i];
+                // Redrawn by a later frame (animations keep hitting the same spot), copied with that one
+                bool covered = false;
+                for (uint32_t later = seq + 1; !covered && later != newest + 1; later++)
+                {
+                    const FrameAreas &later_areas = frame_areas_[later % kAreaHistory];
+                    for (int j = 0; !covered && j < later_areas.count; j++)
+                    {
+                        covered = lv_area_is_in(&area, &later_areas.areas[j], 0);
+                    }
+                }
+                if (covered)
+                {
+                    continue;
+                }
+                if (dma.started() && lv_area_get_width(&area) * 2 >= panel_width_)
+                {
+                    spans[span_count++] = {area.y1, area.y2};
+                    continue;
+                }
+                const size_t row_bytes = lv_area_get_width(&area) * bytes_per_pixel_;
+                SyncJob job = {front, back, row_bytes_full, (size_t)area.x1 * bytes_per_pixel_, (size_t)area.y1, row_bytes};
+                scheduler.Run(lv_area_get_height(&area), std::max<int>(1, kSyncBandBytes / row_bytes), copy_rows, &job);
+                synced_bytes += row_bytes * lv_area_get_height(&area);
+            }
+        }
+    }
+
+    // Overlapping and adjacent row spans go out as one transfer, which runs while the next frame
+    // renders. Flush waits for it before rotating into this buffer again.
+    std::sort(spans, spans + span_count, [](const RowSpan &a, const RowSpan &b)
+              { return a.y1 < b.y1; });
+    for (int i = 0; i < span_count;)
+    {
+        RowSpan merged = spans[i++];
+        while (i < span_count && spans[i].y1 <= merged.y2 + 1)
+        {
+            merged.y2 = std::max(merged.y2, spans[i++].y2);
+        }
+        const size_t offset = (size_t)merged.y1 * row_bytes_full;
+        const size_t bytes = (size_t)(merged.y2 - merged.y1 + 1) * row_bytes_full;
+        dma.Copy(back + offset, front + offset, bytes);
+        synced_bytes += bytes;
+        sync_in_flight_ = true;
+    }
+
+    portENTER_CRITICAL(&stats_lock_);
+    refresh_stats_.last_frame_synced_bytes = synced_bytes;
+    refresh_stats_.total_synced_bytes += synced_bytes;
+    portEXIT_CRITICAL(&stats_lock_);
+}
+
+void RgbLcdDisplay::WaitForVsync()
+{
+    // A notification left over from an earlier frame must not end the wait early
+    ulTaskNotifyValueClear(nullptr, UINT32_MAX);
+    waiting_for_vsync_.store(true, std::memory_order_relaxed);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    waiting_for_vsync_.store(false, std::memory_order_relaxed);
+}
+
+void RgbLcdDisplay::StartVsyncRefresh()
+{
+    if (display_ == nullptr || render_task_ != nullptr)
+    {
+        return;
+    }
+
+    // Frames are rendered by our own task at the panel's frame boundary instead of LVGL's refresh
+    // timer. Animation timestamps come straight from esp_timer rather than the port's tick.
+    lvgl_port_lock(0);
+    lv_tick_set_cb([]() -> uint32_t
+                   { return esp_timer_get_time() / 1000; });
+    RenderOnVsync(display_);
+    // Layers too, so their flushes never run on the port task and wait for a latch there
+    for (auto layer : layers_)
+    {
+        if (layer != nullptr)
+        {
+            RenderOnVsync(layer->display());
+        }
+    }
+    // Posted commands request a vsync refresh instead
+    if (ui_drain_timer_ != nullptr)
+    {
+        lv_timer_delete(ui_drain_timer_);
+        ui_drain_timer_ = nullptr;
+    }
+    lvgl_port_unlock();
+
+    const int helper_core = BandScheduler::GetInstance().helper_core();
+    BaseType_t ret = xTaskCreatePinnedToCore(RenderTask, "lvgl_render", kRenderTaskStack, this, kRenderTaskPriority,
+                                             &render_task_, helper_core >= 0 ? helper_core ^ 1 : tskNO_AFFINITY);
+    if (ret != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create the render task");
+        render_task_ = nullptr;
+        return;
+    }
+    // Whatever was invalidated before the switch
+    RequestRefresh();
+    ESP_LOGI(TAG, "Rendering on vsync");
+}
+
+void RgbLcdDisplay::RenderOnVsync(lv_display_t *display)
+{
+    lv_display_delete_refr_timer(display);
+    // Anything invalidated while a refresh runs is drawn by that refresh
+    lv_display_add_event_cb(display, [](lv_event_t *e)
+                            {
+                                auto display = static_cast<RgbLcdDisplay *>(lv_event_get_user_data(e));
+                                if (!display->in_refresh_)
+                                {
+                                    display->RequestRefresh();
+                                } },
+                            LV_EVENT_INVALIDATE_AREA, this);
+}
+
+LayerDisplay *RgbLcdDisplay::CreateLayer(int index, ScanoutLayerFormat format, int x, int y, int width, int height)
+{
+    if (scanout_ == nullptr)
+    {
+        ESP_LOGW(TAG, "Layers need the scan-out stage");
+        return nullptr;
+    }
+    if (index < 0 || index >= PanelScanout::kMaxLayers || layers_[index] != nullptr)
+    {
+        ESP_LOGE(TAG, "Layer slot %d is not free", index);
+        return nullptr;
+    }
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || x + width > width_ || y + height > height_)
+    {
+        ESP_LOGE(TAG, "Layer %dx%d at %d,%d is not on the screen", width, height, x, y);
+        return nullptr;
+    }
+    lvgl_port_lock(0);
+    layers_[index] = new LayerDisplay(scanout_, index, format, x, y, width, height, panel_width_, panel_height_,
+                                      mirror_x_, mirror_y_, swap_xy_);
+    if (render_task_ != nullptr)
+    {
+        RenderOnVsync(layers_[index]->display());
+    }
+    lvgl_port_unlock();
+    return layers_[index];
+}
+
+FramebufferFootprint RgbLcdDisplay::GetLayerFootprint() const
+{
+    FramebufferFootprint footprint = {};
+    for (auto layer : layers_)
+    {
+        if (layer != nullptr)
+        {
+            footprint.psram_bytes += layer->footprint().psram_bytes;
+            footprint.internal_bytes += layer->footprint().internal_bytes;
+        }
+    }
+    return footprint;
+}
+
+bool RgbLcdDisplay::MoveStatusToOverlay()
+{
+    if (status_label_ == nullptr || notification_label_ == nullptr)
+    {
+        return false;
+    }
+    // Bounding box of the two top-aligned labels: from the status label's offset to a line below
+    // the notification label's
+    lvgl_port_lock(0);
+    const lv_font_t *font = lv_obj_get_style_text_font(lv_display_get_screen_active(display_), LV_PART_MAIN);
+    const int status_y = lv_obj_get_style_y(status_label_, LV_PART_MAIN);
+    const int notification_y = lv_obj_get_style_y(notification_label_, LV_PART_MAIN);
+    lvgl_port_unlock();
+    const int top = std::min(status_y, notification_y);
+    const int height = std::max(status_y, notification_y) + lv_font_get_line_height(font) - top;
+    const int width = std::min<int>(width_, kStatusOverlayMaxWidth);
+    LayerDisplay *overlay = CreateLayer(kStatusLayer, ScanoutLayerFormat::kArgb8888, (width_ - width) / 2, top, width,
+                                        height);
+    if (overlay == nullptr)
+    {
+        return false;
+    }
+
+    // Same font as the main screen. The labels take the overlay's width and cut text that does
+    // not fit with dots instead of growing out of it.
+    lvgl_port_lock(0);
+    lv_obj_t *screen = overlay->screen();
+    lv_obj_set_style_text_font(screen, font, 0);
+    lv_obj_t *labels[] = {status_label_, notification_label_};
+    for (lv_obj_t *label : labels)
+    {
+        const int y = lv_obj_get_style_y(label, LV_PART_MAIN) - top;
+        lv_obj_set_parent(label, screen);
+        lv_obj_set_width(label, width);
+        lv_label_set_long_mode(label, LV_LABEL_LONG_DOT);
+        lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0);
+        lv_obj_align(label, LV_ALIGN_TOP_MID, 0, y);
+    }
+    lvgl_port_unlock();
+    RequestRefresh();
+    ESP_LOGI(TAG, "Status and notification labels moved to scan-out overlay %d", kStatusLayer);
+    return true;
+}
+
+bool RgbLcdDisplay::SetRingView(int y, int height)
+{
+    if (scanout_ == nullptr || !swap_xy_)
+    {
+        return false;
+    }
+    if (y < 0 || height < 0 || y + height > height_)
+    {
+        ESP_LOGE(TAG, "Ring rows %d..%d are not on the screen", y, y + height);
+        return false;
+    }
+
+    // Whatever the old band held is stored rotated, draw it again in place
+    if (ring_height_ > 0 && ring_scroll_ != 0)
+    {
+        lv_area_t band = {0, ring_y_, width_ - 1, ring_y_ + ring_height_ - 1};
+        lv_inv_area(display_, &band);
+    }
+    ring_y_ = y;
+    ring_height_ = height;
+    ring_scroll_ = 0;
+
+    // UI rows are panel columns
+    ScanoutRing ring;
+    if (height > 0)
+    {
+        ring.x = mirror_x_ ? panel_width_ - y - height : y;
+        ring.width = height;
+        ring.height = panel_height_;
+    }
+    for (int i = 0; i < num_fbs_; i++)
+    {
+        scanout_->SetRingOffset(i, 0);
+    }
+    scanout_->SetRing(ring);
+    return true;
+}
+
+void RgbLcdDisplay::ScrollRing(int dy)
+{
+    if (ring_height_ > 0)
+    {
+        ring_scroll_ = ((ring_scroll_ + dy) % ring_height_ + ring_height_) % ring_height_;
+    }
+}
+
+void RgbLcdDisplay::RequestRefresh()
+{
+    // Picked up by the next frame-done interrupt. In timer mode ui_drain_timer_ finds the command,
+    // producers never take the LVGL lock.
+    if (render_task_ != nullptr)
+    {
+        refresh_requested_.store(true, std::memory_order_relaxed);
+    }
+}
+
+void RgbLcdDisplay::RenderTask(void *arg)
+{
+    auto display = static_cast<RgbLcdDisplay *>(arg);
+    for (;;)
+    {
+        // Asleep until a vsync finds a refresh requested
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // A presented frame ends on a buffer switch, so while there is more to draw the next
+        // frame starts straight away instead of a vsync later
+        bool presented;
+        do
+        {
+            display->refresh_requested_.store(false, std::memory_order_relaxed);
+            display->frame_presented_ = false;
+            lvgl_port_lock(0);
+            display->in_refresh_ = true;
+            lv_anim_refr_now();
+            lv_display_refr_timer(nullptr);
+            // UI commands applied by the main display's refresh may have changed a layer. Layers have
+            // no refresh timer in this mode (lv_refr_now would skip them), so each one is refreshed
+            // as the default display.
+            lv_display_t *main_display = lv_display_get_default();
+            for (auto layer : display->layers_)
+            {
+                if (layer != nullptr)
+                {
+                    lv_display_set_default(layer->display());
+                    lv_display_refr_timer(nullptr);
+                }
+            }
+            lv_display_set_default(main_display);
+            display->in_refresh_ = false;
+            if (lv_anim_count_running() > 0)
+            {
+                display->refresh_requested_.store(true, std::memory_order_relaxed);
+            }
+            lvgl_port_unlock();
+            presented = display->frame_presented_;
+        } while (presented && display->refresh_requested_.load(std::memory_order_relaxed));
+    }
+}
+
+void RgbLcdDisplay::OnRenderStart()
+{
+    // Runs in the LVGL task once the invalidated areas of this frame have been joined. Full speed
+    // until RENDER_READY, after the last area has been flushed and presented.
+    pm_lock_.Acquire();
+    render_start_us_ = esp_timer_get_time();
+    frame_flush_us_ = 0;
+    frame_vsync_wait_us_ = 0;
+
+    // Pacing: this frame is due one pace interval after the previous one, or at the next vsync if
+    // that has gone by already. Slots a late frame made the cadence skip count as dropped.
+    render_start_vsync_ = panel_frames();
+    uint32_t deadline = frame_deadline_ + pace_vsyncs_;
+    uint32_t skipped = 0;
+    if (static_cast<int32_t>(render_start_vsync_ + 1 - deadline) > 0)
+    {
+        skipped = prev_frame_late_ ? (render_start_vsync_ + 1 - deadline) / pace_vsyncs_ : 0;
+        deadline = render_start_vsync_ + 1;
+    }
+    frame_deadline_ = deadline;
+    if (skipped > 0)
+    {
+        RecordDropped(skipped);
+    }
+
+    uint32_t areas = 0;
+    uint32_t rendered_bytes = 0;
+    for (uint32_t i = 0; i < display_->inv_p; i++)
+    {
+        if (display_->inv_area_joined[i])
+        {
+            continue;
+        }
+        areas++;
+        rendered_bytes += lv_area_get_size(&display_->inv_areas[i]) * bytes_per_pixel_;
+    }
+
+    // In dirty-rect direct mode LVGL brings the back buffer up to date by copying the
+    // areas drawn in the previous frame out of the buffer being scanned out. Areas that
+    // are redrawn now are skipped by LVGL, so this is an upper bound. The rotated path
+    // counts its own copies in SyncBackBuffer.
+    uint32_t synced_bytes = 0;
+    if (refresh_mode_ == RgbRefreshMode::kDirtyRect && !swap_xy_)
+    {
+        synced_bytes = pending_sync_bytes_;
+        pending_sync_bytes_ = rendered_bytes;
+    }
+
+    portENTER_CRITICAL(&stats_lock_);
+    refresh_stats_.frames++;
+    refresh_stats_.last_frame_areas = areas;
+    refresh_stats_.last_frame_rendered_bytes = rendered_bytes;
+    refresh_stats_.last_frame_synced_bytes = synced_bytes;
+    refresh_stats_.total_rendered_bytes += rendered_bytes;
+    refresh_stats_.total_synced_bytes += synced_bytes;
+    portEXIT_CRITICAL(&stats_lock_);
+
+    ESP_LOGD(TAG, "Frame %lu: %lu areas, %lu bytes rendered, %lu bytes synced",
+             (unsigned long)refresh_stats_.frames, (unsigned long)areas,
+             (unsigned long)rendered_bytes, (unsigned long)synced_bytes);
+}
+
+void RgbLcdDisplay::LogPanelStats()
+{
+    if (scanout_ == nullptr)
+    {
+        return;
+    }
+    ScanoutStats scan = scanout_->GetStats();
+    ESP_LOGI(TAG, "scanout: %lu frames, %lu through the colour LUT, %lu LUT updates, %lu with layers, %lu layer "
+                  "updates | bounce fill %.2f ms per frame, longest %lu us",
+             (unsigned long)scan.frames, (unsigned long)scan.lut_frames, (unsigned long)scan.lut_updates,
+             (unsigned long)scan.layer_frames, (unsigned long)scan.layer_updates,
+             scan.frames > 0 ? scan.fill_us / 1000.0f / scan.frames : 0.0f, (unsigned long)scan.max_fill_us);
+}
+
+RefreshStats RgbLcdDisplay::GetRefreshStats()
+{
+    portENTER_CRITICAL(&stats_lock_);
+    RefreshStats stats = refresh_stats_;
+    portEXIT_CRITICAL(&stats_lock_);
+    return stats;
+}
+
+void RgbLcdDisplay::SetRefreshTimings(const RgbRefreshTiming *timings, int count, int current_hz)
+{
+    refresh_timing_count_ = std::min(count, kMaxRefreshTimings);
+    for (int i = 0; i < refresh_timing_count_; i++)
+    {
+        refresh_timings_[i] = timings[i];
+    }
+    refresh_rate_hz_ = current_hz;
+}
+
+bool RgbLcdDisplay::SetRefreshRate(int hz)
+{
+    const RgbRefreshTiming *timing = nullptr;
+    for (int i = 0; i < refresh_timing_count_; i++)
+    {
+        if (refresh_timings_[i].hz == hz)
+        {
+            timing = &refresh_timings_[i];
+        }
+    }
+    if (timing == nullptr)
+    {
+        ESP_LOGW(TAG, "No panel timing for %d Hz", hz);
+        return false;
+    }
+    if (hz == refresh_rate_hz_)
+    {
+        return true;
+    }
+
+    // The driver latches the new pixel clock in its VSYNC interrupt, scan-out never changes speed mid-frame
+    esp_err_t ret = esp_lcd_rgb_panel_set_pclk(panel_, timing->pclk_hz);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to set pixel clock %lu Hz: %s", (unsigned long)timing->pclk_hz, esp_err_to_name(ret));
+        return false;
+    }
+
+    lvgl_port_lock(0);
+    if (render_task_ != nullptr)
+    {
+        // Vsync mode renders on frame-done and follows the new rate by itself, but lateness was
+        // judged against the old frame period: start pacing over from every vsync
+        pace_vsyncs_ = 1;
+        late_history_ = 0;
+        fast_frames_ = 0;
+    }
+    else
+    {
+        // Render no faster than the panel scans out
+        lv_timer_t *refr_timer = lv_display_get_refr_timer(display_);
+        if (refr_timer != nullptr)
+        {
+            lv_timer_set_period(refr_timer, 1000 / hz);
+        }
+    }
+    lvgl_port_unlock();
+
+    ESP_LOGI(TAG, "Refresh rate %d -> %d Hz (pclk %.2f MHz)", refresh_rate_hz_, hz, timing->pclk_hz / 1e6f);
+    refresh_rate_hz_ = hz;
+    return true;
+}
@@ -2,12 +2,72 @@
 #define LCD_DISPLAY_H
 
 #include "display.h"
+#include "framebuffer_profile.h"
+#include "panel_scanout.h"
 #include <esp_lcd_panel_io.h>
 #include <esp_lcd_panel_ops.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <atomic>
 
+class LayerDisplay;
+
+// How RgbLcdDisplay refreshes the two PSRAM frame buffers it renders into
+enum class RgbRefreshMode
+{
+    kFullRefresh, // every refresh redraws the whole frame
+    kDirtyRect,   // only invalidated areas are redrawn and then copied into the other frame buffer
+};
+
+// PSRAM traffic caused by rendering, counted per refreshed frame
+struct RefreshStats
+{
+    uint32_t frames = 0;                    // refreshed frames since start-up
+    uint32_t last_frame_areas = 0;          // areas redrawn in the last frame
+    uint32_t last_frame_rendered_bytes = 0; // bytes LVGL drew in the last frame
+    uint32_t last_frame_synced_bytes = 0;   // bytes copied between frame buffers in the last frame
+    uint64_t total_rendered_bytes = 0;
+    uint64_t total_synced_bytes = 0;
+};
+
+// Frame time histogram with power-of-two millisecond buckets:
+// <1, <2, <4, <8, <16, <32, <64 and >=64 ms
+struct FrameTimeHistogram
+{
+    static constexpr int kBuckets = 8;
+    uint16_t buckets[kBuckets] = {};
+    uint32_t avg_us = 0;
+    uint32_t max_us = 0;
+};
+
+// Frames against their pacing deadline (the vsync they were due at), since start-up
+struct PresentStats
+{
+    uint32_t on_time = 0; // handed to the panel in time to latch at their deadline
+    uint32_t late = 0;    // latched after their deadline
+    uint32_t dropped = 0; // deadline slots skipped after a late frame, and queued frames replaced before they latched
+    uint32_t held = 0;    // finished early and held back to keep the cadence
+};
+
+// Timing of the last kFrameStatsWindow presented frames
+struct FrameStats
+{
+    uint32_t frames = 0;       // presented frames since start-up
+    uint32_t panel_frames = 0; // frames scanned out by the panel since start-up
+    uint32_t window = 0;       // frames covered by the histograms
+    float fps = 0;             // presented frames per second over the window
+    FrameTimeHistogram render;     // LVGL drawing, excluding flush callbacks
+    FrameTimeHistogram flush;      // flush callbacks: rotation, copies, buffer hand-over
+    FrameTimeHistogram vsync_wait; // blocked until the panel picked up the new frame buffer
+    PresentStats present;
+};
+
 class LcdDisplay : public Display
 {
+public:
+    FrameStats GetFrameStats();
+
 protected:
     esp_lcd_panel_io_handle_t panel_io_ = nullptr;
     esp_lcd_panel_handle_t panel_ = nullptr;
@@ -21,21 +81,212 @@ protected:
     // Make these accessible to setup function
     friend void setup_ui_styles_task(void *param);
 
+    // Called by subclasses once per presented frame and from the panel's frame-done ISR
+    void RecordFrame(uint32_t render_us, uint32_t flush_us, uint32_t vsync_wait_us);
+    void RecordPanelFrame() { panel_frames_.fetch_add(1, std::memory_order_relaxed); }
+    uint32_t panel_frames() const { return panel_frames_.load(std::memory_order_relaxed); }
+    void RecordPresent(bool late, bool held);
+    void RecordDropped(uint32_t count);
+    // Extra lines for the periodic stats log
+    virtual void LogPanelStats() {}
+
 protected:
     // 添加protected构造函数
     LcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel, int width, int height);
 
 public:
     virtual ~LcdDisplay();
+
+private:
+    static constexpr int kFrameStatsWindow = 128;
+
+    struct FrameSample
+    {
+        int64_t present_us;
+        uint32_t render_us;
+        uint32_t flush_us;
+        uint32_t vsync_wait_us;
+    };
+
+    FrameSample frame_samples_[kFrameStatsWindow];
+    uint32_t frame_count_ = 0;
+    PresentStats present_stats_;
+    std::atomic<uint32_t> panel_frames_{0};
+    portMUX_TYPE frame_stats_lock_ = portMUX_INITIALIZER_UNLOCKED;
+    esp_timer_handle_t frame_stats_timer_ = nullptr;
+    uint32_t last_logged_frames_ = 0;
+    uint32_t last_logged_panel_frames_ = 0;
+    int64_t last_logged_us_ = 0;
+
+    void LogFrameStats();
 };
 
 // RGB LCD显示器
+// A precomputed panel timing RgbLcdDisplay can switch to at runtime, only the pixel clock differs
+struct RgbRefreshTiming
+{
+    int hz;
+    uint32_t pclk_hz;
+};
+
 class RgbLcdDisplay : public LcdDisplay
 {
 public:
     RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                   int width, int height, int offset_x, int offset_y,
-                  bool mirror_x, bool mirror_y, bool swap_xy);
+                  bool mirror_x, bool mirror_y, bool swap_xy,
+                  RgbRefreshMode refresh_mode = RgbRefreshMode::kDirtyRect,
+                  const FramebufferProfileConfig &profile = GetFramebufferProfile(FramebufferProfile::kBalanced),
+                  PanelScanout *scanout = nullptr);
+
+    virtual ~RgbLcdDisplay();
+
+    RefreshStats GetRefreshStats();
+
+    // Rates SetRefreshRate accepts, current_hz is what the panel was created with
+    void SetRefreshTimings(const RgbRefreshTiming *timings, int count, int current_hz);
+    virtual bool SetRefreshRate(int hz) override;
+    virtual int refresh_rate() const override { return refresh_rate_hz_; }
+
+    // Render from the panel's frame-done interrupt instead of LVGL's refresh timer: a frame starts
+    // at the first vsync after something was invalidated or a UI command was posted, and nothing
+    // runs while the screen is static
+    void StartVsyncRefresh();
+
+    // A rectangle of the UI rendered on its own LVGL display and composited at scan-out in layer
+    // slot index (layer_display.h), owned by this display; nullptr without a scan-out stage or
+    // when the slot is taken. Vsync refresh renders layers right after the main display.
+    LayerDisplay *CreateLayer(int index, ScanoutLayerFormat format, int x, int y, int width, int height);
+    // Surfaces and draw buffers of all layers
+    FramebufferFootprint GetLayerFootprint() const;
+    // Status and notification labels go to an overlay in the top layer slot, so their updates are
+    // blended over the frame buffer instead of redrawn into it
+    bool MoveStatusToOverlay();
+
+    // Keeps the full-width band of UI rows [y, y + height) in the frame buffers as a scan-out ring
+    // (ring_scroll_view.h); false without a scan-out stage or the rotated path. Height 0 removes
+    // it. Under the LVGL lock.
+    bool SetRingView(int y, int height);
+    // Scrolls the ring band by dy rows, positive brings up what is below, from the next presented
+    // frame on. The caller invalidates the rows this exposes. Under the LVGL lock.
+    void ScrollRing(int dy);
+
+private:
+    static constexpr int kMaxRefreshTimings = 4;
+    // Flushes of one frame that fit in the rotated path's dirty list, larger frames copy the whole buffer
+    static constexpr int kMaxFrameAreas = 64;
+    // Work split between the cores (band_scheduler.h): source columns per rotated band, bytes per
+    // copied band when syncing the back buffer
+    static constexpr int kRotateBandColumns = 64;
+    static constexpr int kSyncBandBytes = 16 * 1024;
+    // Status overlay: the topmost scan-out layer, just covering the rows of the status and the
+    // notification label, centred and at most this wide
+    static constexpr int kStatusLayer = PanelScanout::kMaxLayers - 1;
+    static constexpr int kStatusOverlayMaxWidth = 480;
+
+    RgbRefreshMode refresh_mode_;
+    // Fills the bounce buffers from frame buffers of its own, nullptr when the panel driver does
+    PanelScanout *scanout_;
+    LayerDisplay *layers_[PanelScanout::kMaxLayers] = {};
+    RefreshStats refresh_stats_;
+    uint32_t pending_sync_bytes_ = 0;
+    portMUX_TYPE stats_lock_ = portMUX_INITIALIZER_UNLOCKED;
+
+    // Native panel resolution, width_/height_ hold the LVGL resolution after swap_xy
+    int panel_width_;
+    int panel_height_;
+    bool mirror_x_;
+    bool mirror_y_;
+    bool swap_xy_;
+    // 2 for RGB565, 1 when the scan-out stage expands palette indices (LVGL renders L8)
+    uint32_t bytes_per_pixel_ = 2;
+
+    // With a single frame buffer both entries point at it and frames are drawn in place
+    static constexpr int kMaxFrameBuffers = 3;
+    int num_fbs_;
+    uint8_t *frame_buffers_[kMaxFrameBuffers] = {nullptr, nullptr, nullptr};
+    int back_buffer_ = 1;
+    // Present queue: the buffer being scanned out and the one handed over but not latched yet
+    // (-1 for none), updated by the frame-done ISR under present_lock_
+    int scanout_buffer_ = 0;
+    int pending_buffer_ = -1;
+    portMUX_TYPE present_lock_ = portMUX_INITIALIZER_UNLOCKED;
+
+    // Frame pacing against panel vsyncs (panel_frames), see PresentFrame
+    static constexpr int kLateFramesForHalfRate = 4;  // of the last 8
+    static constexpr int kFastFramesForFullRate = 60; // in a row that fit one vsync
+    uint32_t frame_deadline_ = 0;
+    uint32_t render_start_vsync_ = 0;
+    int pace_vsyncs_ = 1;
+    uint32_t late_history_ = 0;
+    int fast_frames_ = 0;
+    bool prev_frame_late_ = false;
+    int draw_buffer_lines_;
+    int num_draw_buffers_;
+    void *draw_buffers_[2] = {nullptr, nullptr};
+    TaskHandle_t flush_task_ = nullptr;
+    std::atomic<bool> waiting_for_vsync_{false};
+
+    // Vsync-driven refresh, see StartVsyncRefresh
+    static constexpr int kRenderTaskStack = 8 * 1024;
+    static constexpr int kRenderTaskPriority = 4;
+    TaskHandle_t render_task_ = nullptr;
+    std::atomic<bool> refresh_requested_{false};
+    bool in_refresh_ = false; // written and read with the LVGL lock held
+
+    // Timer mode: how often the LVGL task looks for posted UI commands while nothing is drawn
+    static constexpr int kUiDrainPeriodMs = 20;
+    lv_timer_t *ui_drain_timer_ = nullptr;
+    bool frame_presented_ = false;
+
+    // Panel areas written by the last frames (rotated path), indexed by frame number. A free buffer
+    // is at most two frames behind with three buffers, so that many frames plus the current one.
+    static constexpr uint32_t kAreaHistory = kMaxFrameBuffers;
+    struct FrameAreas
+    {
+        int count = 0; // above kMaxFrameAreas the whole frame counts as drawn
+        lv_area_t areas[kMaxFrameAreas];
+    };
+    FrameAreas frame_areas_[kAreaHistory];
+    uint32_t frame_seq_ = 1;                          // frame being drawn
+    uint32_t buffer_frames_[kMaxFrameBuffers] = {};   // frame each buffer holds, 0 for none
+    bool sync_in_flight_ = false;                     // back buffer sync still running on the copy engine
+
+    // Ring band (SetRingView): UI row ring_y_ + v of the band is stored at row
+    // ring_y_ + (v + ring_scroll_) % ring_height_; written and read with the LVGL lock held
+    int ring_y_ = 0;
+    int ring_height_ = 0;
+    int ring_scroll_ = 0;
+
+    // Timing of the frame being rendered
+    int64_t render_start_us_ = 0;
+    uint32_t frame_flush_us_ = 0;
+    uint32_t frame_vsync_wait_us_ = 0;
+
+    RgbRefreshTiming refresh_timings_[kMaxRefreshTimings];
+    int refresh_timing_count_ = 0;
+    int refresh_rate_hz_ = 0;
+
+    // Frame-done interrupt: latches the present queue and wakes whoever waits for the vsync
+    bool OnPanelFrameDone();
+    // Points scan-out at frame from the next frame on
+    void HandOverFrame(void *frame);
+    virtual void LogPanelStats() override;
+    void OnRenderStart();
+    void Flush(const lv_area_t *area, uint8_t *px_map);
+    lv_area_t ToPanelArea(const lv_area_t *area) const;
+    void RotateIntoBackBuffer(const lv_area_t *area, const uint8_t *px_map);
+    // RotateIntoBackBuffer with the rows of the ring band moved to where they are stored
+    void RotateThroughRing(const lv_area_t *area, const uint8_t *px_map);
+    // Hands the finished frame to the panel, returns how long it was blocked waiting for vsyncs
+    int64_t PresentFrame(void *frame);
+    void PaceFrames(bool late);
+    void SyncBackBuffer(int source);
+    void WaitForVsync();
+    virtual void RequestRefresh() override;
+    // Vsync mode: hands a display's refresh from its LVGL timer to the render task
+    void RenderOnVsync(lv_display_t *display);
+    static void RenderTask(void *arg);
 };
 
 #endif // LCD_DISPLAY_H
\ No newline at end of file
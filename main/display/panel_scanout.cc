@@ -0,0 +1,491 @@
+#include "panel_scanout.h"
+#include "rgb565_dither.h"
+#include <esp_lcd_panel_rgb.h>
+#include <esp_heap_caps.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_err.h>
+#include <esp_timer.h>
+#include <freertos/task.h>
+#include <cassert>
+#include <cstring>
+
+#define TAG "PanelScanout"
+
+PanelScanout::PanelScanout(esp_lcd_panel_handle_t panel, int width, int height, int num_fbs, bool mono)
+    : panel_(panel), width_(width), height_(height), frame_pixels_(static_cast<size_t>(width) * height),
+      bytes_per_pixel_(mono ? 1 : 2)
+{
+    num_fbs_ = num_fbs < 1 ? 1 : num_fbs > kMaxFrameBuffers ? kMaxFrameBuffers : num_fbs;
+    for (int i = 0; i < num_fbs_; i++)
+    {
+        frame_buffers_[i] = static_cast<uint8_t *>(
+            heap_caps_aligned_calloc(64, frame_pixels_, bytes_per_pixel_, MALLOC_CAP_SPIRAM));
+        assert(frame_buffers_[i] != nullptr);
+    }
+
+    // Looked up for every pixel from the interrupt, so they stay in internal RAM
+    luts_ = static_cast<CompiledLut *>(heap_caps_malloc(2 * sizeof(CompiledLut), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    assert(luts_ != nullptr);
+    lut_mutex_ = xSemaphoreCreateMutex();
+    assert(lut_mutex_ != nullptr);
+    layer_mutex_ = xSemaphoreCreateMutex();
+    assert(layer_mutex_ != nullptr);
+    layers_latched_ = xSemaphoreCreateBinary();
+    assert(layers_latched_ != nullptr);
+    calibration_ = ColorLut::Identity();
+    RampPalette(0x0000, 0xFFFF, palette_);
+    CompileLut(&luts_[0]);
+    if (mono)
+    {
+        // Every pixel goes through the palette
+        pm_lock_.Acquire();
+        lut_pm_held_ = true;
+    }
+
+    const esp_lcd_rgb_panel_event_callbacks_t callbacks = {
+        .on_bounce_empty = OnBounceEmpty,
+    };
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel_, &callbacks, this));
+    ESP_LOGI(TAG, "Filling the bounce buffers from %d %s frame buffer(s) of %dx%d", num_fbs_,
+             mono ? "monochrome" : "RGB565", width_, height_);
+}
+
+PanelScanout::~PanelScanout()
+{
+    const esp_lcd_rgb_panel_event_callbacks_t callbacks = {};
+    esp_lcd_rgb_panel_register_event_callbacks(panel_, &callbacks, nullptr);
+    for (auto frame_buffer : frame_buffers_)
+    {
+        heap_caps_free(frame_buffer);
+    }
+    heap_caps_free(luts_);
+    vSemaphoreDelete(lut_mutex_);
+    vSemaphoreDelete(layer_mutex_);
+    vSemaphoreDelete(layers_latched_);
+}
+
+void PanelScanout::Present(const void *frame)
+{
+    for (int i = 0; i < num_fbs_; i++)
+    {
+        if (frame == frame_buffers_[i])
+        {
+            pending_.store(i, std::memory_order_release);
+            return;
+        }
+    }
+    ESP_LOGE(TAG, "Present: %p is not a scan-out frame buffer", frame);
+}
+
+void PanelScanout::SetFrameDoneCallback(FrameDoneFn fn, void *ctx)
+{
+    // The context goes in before the interrupt can see the function
+    frame_done_ctx_ = ctx;
+    frame_done_.store(fn, std::memory_order_release);
+}
+
+void PanelScanout::SetCalibration(const ColorLut &lut)
+{
+    xSemaphoreTake(lut_mutex_, portMAX_DELAY);
+    calibration_ = lut;
+    UpdateLut();
+    xSemaphoreGive(lut_mutex_);
+}
+
+void PanelScanout::SetWhitePoint(int kelvin)
+{
+    xSemaphoreTake(lut_mutex_, portMAX_DELAY);
+    white_point_kelvin_ = kelvin;
+    UpdateLut();
+    xSemaphoreGive(lut_mutex_);
+}
+
+void PanelScanout::SetPalette(const uint16_t palette[256])
+{
+    xSemaphoreTake(lut_mutex_, portMAX_DELAY);
+    memcpy(palette_, palette, sizeof(palette_));
+    UpdateLut();
+    xSemaphoreGive(lut_mutex_);
+}
+
+void PanelScanout::RampPalette(uint16_t dark, uint16_t light, uint16_t palette[256])
+{
+    // Per channel at its own depth, rounded
+    const int from[3] = {dark >> 11, (dark >> 5) & 63, dark & 31};
+    const int to[3] = {light >> 11, (light >> 5) & 63, light & 31};
+    for (int i = 0; i < 256; i++)
+    {
+        int c[3];
+        for (int k = 0; k < 3; k++)
+        {
+            c[k] = from[k] + ((to[k] - from[k]) * i + (to[k] > from[k] ? 127 : -127)) / 255;
+        }
+        palette[i] = static_cast<uint16_t>(c[0] << 11 | c[1] << 5 | c[2]);
+    }
+}
+
+void PanelScanout::CompileLut(CompiledLut *out) const
+{
+    const ColorLut lut = calibration_.Then(ColorLut::WhitePoint(white_point_kelvin_));
+    out->identity = lut.IsIdentity();
+    for (int i = 0; i < 2048; i++)
+    {
+        out->rg[i] = static_cast<uint16_t>(lut.r[i >> 6] << 11 | lut.g[i & 63] << 5);
+    }
+    for (int i = 0; i < 32; i++)
+    {
+        out->b[i] = lut.b[i];
+    }
+    for (int i = 0; i < 256; i++)
+    {
+        const uint16_t p = palette_[i];
+        out->palette[i] = out->rg[p >> 5] | out->b[p & 31];
+    }
+}
+
+void PanelScanout::UpdateLut()
+{
+    // The table a previous change went into is still waiting for its frame boundary
+    while (lut_pending_.load(std::memory_order_acquire))
+    {
+        vTaskDelay(1);
+    }
+
+    CompiledLut *next = &luts_[active_lut_ ^ 1];
+    CompileLut(next);
+    const bool busy = bytes_per_pixel_ == 1 || !next->identity;
+    if (busy && !lut_pm_held_)
+    {
+        pm_lock_.Acquire();
+        lut_pm_held_ = true;
+    }
+    lut_pending_.store(true, std::memory_order_release);
+    if (!busy && lut_pm_held_)
+    {
+        // The old table is looked up until the frame boundary
+        while (lut_pending_.load(std::memory_order_acquire))
+        {
+            vTaskDelay(1);
+        }
+        pm_lock_.Release();
+        lut_pm_held_ = false;
+    }
+}
+
+void PanelScanout::SetRing(const ScanoutRing &ring)
+{
+    if (ring.width != 0 &&
+        (ring.x < 0 || ring.y < 0 || ring.width <= 0 || ring.height <= 0 ||
+         ring.x + ring.width > width_ || ring.y + ring.height > height_))
+    {
+        ESP_LOGE(TAG, "SetRing: %dx%d at %d,%d is not inside the panel", ring.width, ring.height, ring.x, ring.y);
+        return;
+    }
+
+    xSemaphoreTake(layer_mutex_, portMAX_DELAY);
+    WaitLayersLatched();
+    const int next = active_layers_ ^ 1;
+    memcpy(layers_[next], layers_[active_layers_], sizeof(layers_[0]));
+    rings_[next] = ring;
+    CommitLayers(next);
+    xSemaphoreGive(layer_mutex_);
+}
+
+void PanelScanout::WaitLayersLatched()
+{
+    // A stale give from a change nobody waited for only costs one more check; the timeout covers
+    // a give another waiter took
+    while (layers_pending_.load(std::memory_order_acquire))
+    {
+        xSemaphoreTake(layers_latched_, pdMS_TO_TICKS(kLayerLatchTimeoutMs));
+    }
+}
+
+void PanelScanout::SetRingOffset(int frame_buffer, int offset)
+{
+    ring_offsets_[frame_buffer].store(offset, std::memory_order_relaxed);
+}
+
+void PanelScanout::SetLayer(int index, const ScanoutLayer &layer)
+{
+    if (index < 0 || index >= kMaxLayers)
+    {
+        ESP_LOGE(TAG, "SetLayer: no layer %d", index);
+        return;
+    }
+    if (layer.pixels != nullptr &&
+        (layer.x < 0 || layer.y < 0 || layer.width <= 0 || layer.height <= 0 ||
+         layer.x + layer.width > width_ || layer.y + layer.height > height_))
+    {
+        ESP_LOGE(TAG, "SetLayer: %dx%d at %d,%d is not inside the panel", layer.width, layer.height, layer.x, layer.y);
+        return;
+    }
+
+    xSemaphoreTake(layer_mutex_, portMAX_DELAY);
+    // The set a previous change went into is still waiting for its frame boundary
+    WaitLayersLatched();
+    ScanoutLayer *next = layers_[active_layers_ ^ 1];
+    memcpy(next, layers_[active_layers_], sizeof(layers_[0]));
+    next[index] = layer;
+    rings_[active_layers_ ^ 1] = rings_[active_layers_];
+    CommitLayers(active_layers_ ^ 1);
+    xSemaphoreGive(layer_mutex_);
+}
+
+void PanelScanout::CommitLayers(int next)
+{
+    bool busy = rings_[next].width > 0;
+    for (const auto &layer : layers_[next])
+    {
+        busy = busy || layer.pixels != nullptr;
+    }
+    if (busy && !layers_pm_held_)
+    {
+        pm_lock_.Acquire();
+        layers_pm_held_ = true;
+    }
+    layers_pending_.store(true, std::memory_order_release);
+    if (!busy && layers_pm_held_)
+    {
+        // The old set is composited until the frame boundary
+        WaitLayersLatched();
+        pm_lock_.Release();
+        layers_pm_held_ = false;
+    }
+}
+
+// Straight alpha over RGB565, mixed like lv_color_16_16_mix: 5-bit weights on the G/RB-spread word
+static inline IRAM_ATTR void BlendArgb8888(const uint32_t *in, uint16_t *out, int count, const uint16_t *rg,
+                                           const uint16_t *b)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const uint32_t p = in[i];
+        const uint32_t a = p >> 24;
+        if (a == 0)
+        {
+            continue;
+        }
+        uint32_t fg = ((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F);
+        if (rg != nullptr)
+        {
+            fg = rg[fg >> 5] | b[fg & 31];
+        }
+        if (a == 255)
+        {
+            out[i] = static_cast<uint16_t>(fg);
+            continue;
+        }
+        const uint32_t mix = (a + 4) >> 3;
+        const uint32_t bg = (out[i] | static_cast<uint32_t>(out[i]) << 16) & 0x7E0F81F;
+        fg = (fg | fg << 16) & 0x7E0F81F;
+        const uint32_t mixed = ((((fg - bg) * mix) >> 5) + bg) & 0x7E0F81F;
+        out[i] = static_cast<uint16_t>(mixed >> 16 | mixed);
+    }
+}
+
+// Composites the layers over the lines in the bounce buffer, bottom one first; returns whether there were any
+IRAM_ATTR bool PanelScanout::FillLayers(uint16_t *bounce, int pos_px, int pixels, const CompiledLut &lut)
+{
+    const ScanoutLayer *layers = layers_[active_layers_];
+    const int first_line = pos_px / width_;
+    const int end_line = (pos_px + pixels) / width_;
+    bool any = false;
+    for (int i = 0; i < kMaxLayers; i++)
+    {
+        const ScanoutLayer &layer = layers[i];
+        if (layer.pixels == nullptr)
+        {
+            continue;
+        }
+        any = true;
+        const int y1 = first_line > layer.y ? first_line : layer.y;
+        const int y2 = end_line < layer.y + layer.height ? end_line : layer.y + layer.height;
+        for (int y = y1; y < y2; y++)
+        {
+            uint16_t *out = bounce + (y - first_line) * width_ + layer.x;
+            const auto *in = static_cast<const uint32_t *>(layer.pixels) + (y - layer.y) * layer.width;
+            if (layer.format == ScanoutLayerFormat::kArgb8888)
+            {
+                BlendArgb8888(in, out, layer.width, lut.identity ? nullptr : lut.rg, lut.b);
+                continue;
+            }
+            xrgb8888_to_rgb565_dither(in, out, layer.width, layer.x, y);
+            if (!lut.identity)
+            {
+                for (int x = 0; x < layer.width; x++)
+                {
+                    out[x] = lut.rg[out[x] >> 5] | lut.b[out[x] & 31];
+                }
+            }
+        }
+    }
+    return any;
+}
+
+// Converts count frame buffer pixels to what the panel gets: palette or LUT lookups, or a copy
+IRAM_ATTR void PanelScanout::FillPixels(const uint8_t *src, uint16_t *out, int count, const CompiledLut &lut) const
+{
+    // Word at a time where source and destination allow, which is every whole bounce buffer; ring
+    // segments can start anywhere and take the per-pixel tail
+    const bool aligned = ((reinterpret_cast<uintptr_t>(src) | reinterpret_cast<uintptr_t>(out)) & 3) == 0;
+    int done = 0;
+    if (bytes_per_pixel_ == 1)
+    {
+        // Four levels per word read from PSRAM, two output words
+        const uint16_t *palette = lut.palette;
+        if (aligned)
+        {
+            const auto *in = reinterpret_cast<const uint32_t *>(src);
+            auto *out_words = reinterpret_cast<uint32_t *>(out);
+            const int quads = count / 4;
+            for (int i = 0; i < quads; i++)
+            {
+                const uint32_t four = in[i];
+                out_words[2 * i] = palette[four & 0xFF] | static_cast<uint32_t>(palette[(four >> 8) & 0xFF]) << 16;
+                out_words[2 * i + 1] = palette[(four >> 16) & 0xFF] | static_cast<uint32_t>(palette[four >> 24]) << 16;
+            }
+            done = quads * 4;
+        }
+        for (int i = done; i < count; i++)
+        {
+            out[i] = palette[src[i]];
+        }
+        return;
+    }
+
+    const auto *in = reinterpret_cast<const uint16_t *>(src);
+    if (lut.identity)
+    {
+        memcpy(out, in, count * 2);
+        return;
+    }
+    if (aligned)
+    {
+        // Two pixels per word
+        const auto *in_words = reinterpret_cast<const uint32_t *>(in);
+        auto *out_words = reinterpret_cast<uint32_t *>(out);
+        for (int i = 0; i < count / 2; i++)
+        {
+            const uint32_t two = in_words[i];
+            const uint32_t lo = two & 0xFFFF;
+            const uint32_t hi = two >> 16;
+            out_words[i] = (lut.rg[lo >> 5] | lut.b[lo & 31]) | static_cast<uint32_t>(lut.rg[hi >> 5] | lut.b[hi & 31]) << 16;
+        }
+        done = count & ~1;
+    }
+    for (int i = done; i < count; i++)
+    {
+        out[i] = lut.rg[in[i] >> 5] | lut.b[in[i] & 31];
+    }
+}
+
+// Refills the ring window of the lines in the bounce buffer from their shifted source
+IRAM_ATTR void PanelScanout::FillRing(uint16_t *bounce, int pos_px, int pixels, const CompiledLut &lut)
+{
+    const ScanoutRing &ring = rings_[active_layers_];
+    const int offset = ring_offsets_[current_].load(std::memory_order_relaxed);
+    if (ring.width == 0 || offset == 0)
+    {
+        return;
+    }
+    const int first_line = pos_px / width_;
+    const int end_line = (pos_px + pixels) / width_;
+    const int y1 = first_line > ring.y ? first_line : ring.y;
+    const int y2 = end_line < ring.y + ring.height ? end_line : ring.y + ring.height;
+    const uint8_t *frame = frame_buffers_[current_];
+    for (int y = y1; y < y2; y++)
+    {
+        int src_y = y;
+        int shift = offset;
+        if (ring.along_rows)
+        {
+            src_y = y + offset < ring.y + ring.height ? y + offset : y + offset - ring.height;
+            shift = 0;
+        }
+        const uint8_t *row = frame + (static_cast<size_t>(src_y) * width_ + ring.x) * bytes_per_pixel_;
+        uint16_t *out = bounce + (y - first_line) * width_ + ring.x;
+        FillPixels(row + shift * bytes_per_pixel_, out, ring.width - shift, lut);
+        if (shift > 0)
+        {
+            FillPixels(row, out + ring.width - shift, shift, lut);
+        }
+    }
+}
+
+IRAM_ATTR bool PanelScanout::OnBounceEmpty(esp_lcd_panel_handle_t, void *bounce_buf, int pos_px, int len_bytes,
+                                            void *user_ctx)
+{
+    return static_cast<PanelScanout *>(user_ctx)->FillBounce(bounce_buf, pos_px, len_bytes);
+}
+
+IRAM_ATTR bool PanelScanout::FillBounce(void *bounce, int pos_px, int len_bytes)
+{
+    const int64_t start_us = esp_timer_get_time();
+    const CompiledLut &lut = luts_[active_lut_];
+    const uint8_t *src = frame_buffers_[current_] + static_cast<size_t>(pos_px) * bytes_per_pixel_;
+    const int pixels = len_bytes / 2;
+    FillPixels(src, static_cast<uint16_t *>(bounce), pixels, lut);
+    // Bounce buffers hold whole lines
+    FillRing(static_cast<uint16_t *>(bounce), pos_px, pixels, lut);
+    const bool layered = FillLayers(static_cast<uint16_t *>(bounce), pos_px, pixels, lut);
+
+    bool need_yield = false;
+    const bool frame_end = static_cast<size_t>(pos_px + pixels) >= frame_pixels_;
+    bool lut_swapped = false;
+    bool layers_swapped = false;
+    if (frame_end)
+    {
+        // Frame boundary: the next fill starts the frame presented meanwhile, with the newest table
+        const int pending = pending_.exchange(-1, std::memory_order_acquire);
+        if (pending >= 0)
+        {
+            current_ = pending;
+        }
+        if (lut_pending_.load(std::memory_order_acquire))
+        {
+            active_lut_ ^= 1;
+            lut_pending_.store(false, std::memory_order_release);
+            lut_swapped = true;
+        }
+        if (layers_pending_.load(std::memory_order_acquire))
+        {
+            active_layers_ ^= 1;
+            layers_pending_.store(false, std::memory_order_release);
+            layers_swapped = true;
+            BaseType_t woken = pdFALSE;
+            xSemaphoreGiveFromISR(layers_latched_, &woken);
+            need_yield = woken == pdTRUE;
+        }
+    }
+
+    const uint32_t fill_us = static_cast<uint32_t>(esp_timer_get_time() - start_us);
+    portENTER_CRITICAL_ISR(&stats_lock_);
+    stats_.fill_us += fill_us;
+    stats_.max_fill_us = fill_us > stats_.max_fill_us ? fill_us : stats_.max_fill_us;
+    if (frame_end)
+    {
+        stats_.frames++;
+        stats_.lut_frames += lut.identity ? 0 : 1;
+        stats_.lut_updates += lut_swapped ? 1 : 0;
+        stats_.layer_frames += layered ? 1 : 0;
+        stats_.layer_updates += layers_swapped ? 1 : 0;
+    }
+    portEXIT_CRITICAL_ISR(&stats_lock_);
+
+    FrameDoneFn frame_done = frame_done_.load(std::memory_order_acquire);
+    if (frame_end && frame_done != nullptr)
+    {
+        need_yield = frame_done(frame_done_ctx_) || need_yield;
+    }
+    return need_yield;
+}
+
+ScanoutStats PanelScanout::GetStats()
+{
+    portENTER_CRITICAL(&stats_lock_);
+    ScanoutStats stats = stats_;
+    portEXIT_CRITICAL(&stats_lock_);
+    return stats;
+}
@@ -0,0 +1,187 @@
+#ifndef PANEL_SCANOUT_H
+#define PANEL_SCANOUT_H
+
+#include "color_lut.h"
+#include "pm_activity.h"
+#include <esp_lcd_types.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+struct ScanoutStats
+{
+    uint32_t frames = 0;        // frames filled into the bounce buffers
+    uint32_t lut_frames = 0;    // of those, frames sent through the colour LUT
+    uint32_t lut_updates = 0;   // LUT and palette changes that have reached the screen
+    uint32_t layer_frames = 0;  // frames with at least one layer over the frame buffer
+    uint32_t layer_updates = 0; // layer changes that have reached the screen
+    int64_t fill_us = 0;        // time spent filling bounce buffers
+    uint32_t max_fill_us = 0;   // longest single bounce buffer fill
+};
+
+enum class ScanoutLayerFormat
+{
+    kXrgb8888, // opaque, 8 bits per channel, ordered-dithered to RGB565 (rgb565_dither.h)
+    kArgb8888, // blended over what is below with LVGL's RGB565 mix, alpha 0 leaves it untouched
+};
+
+// A rectangle of the panel scanned out from a surface of its own instead of the frame buffer
+struct ScanoutLayer
+{
+    const void *pixels = nullptr; // width x height in panel orientation, rows packed; nullptr for none
+    ScanoutLayerFormat format = ScanoutLayerFormat::kXrgb8888;
+    int x = 0; // panel coordinates
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// A window of the panel shown from the frame buffer rotated by a per-buffer offset, so content
+// can scroll without being redrawn: the frame buffer holds the window as a ring, and a scroll
+// only draws what it exposes. Along rows, line y of the window shows line y + offset; otherwise
+// column x shows column x + offset, both wrapping inside the window.
+struct ScanoutRing
+{
+    int x = 0; // panel coordinates, width 0 for none
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    bool along_rows = false;
+};
+
+// The bounce buffer stage of the RGB panel, run by us instead of the driver: the panel is created
+// with no_fb, the frame buffers are allocated here, and every bounce buffer is filled from the one
+// being scanned out. That is where per-unit calibration and night mode are applied, one pass
+// over each line on its way to the panel, with no extra pass over the PSRAM frame buffer.
+// In monochrome mode the frame buffers hold one byte of luminance per pixel, expanded to RGB565
+// through a 256 entry tint ramp on the same pass, which halves their PSRAM size and the scan-out
+// reads. It is not a colour mode: hues are lost when LVGL renders L8.
+// A ring window can scroll part of the frame buffer without redrawing it, and layers are
+// composited over the result on the same pass, so content that needs more than
+// 16 bits is only converted on its way to the panel, and overlays that change often are drawn
+// into buffers of their own without touching the frame buffer below them.
+// Present, SetCalibration, SetWhitePoint, SetPalette, SetLayer and SetRing take effect at the next
+// frame boundary.
+class PanelScanout
+{
+public:
+    // Called from the bounce interrupt after the last fill of each frame, returns whether a task was woken
+    typedef bool (*FrameDoneFn)(void *ctx);
+
+    // Allocates num_fbs frame buffers and takes over the panel's bounce buffer callbacks; the
+    // panel must have been created with flags.no_fb and a bounce buffer, and not be initialised
+    // yet so the first bounce fill already comes here. mono picks 8-bit luminance instead of
+    // RGB565 frame buffers.
+    PanelScanout(esp_lcd_panel_handle_t panel, int width, int height, int num_fbs, bool mono = false);
+    ~PanelScanout();
+
+    int num_frame_buffers() const { return num_fbs_; }
+    // 1 in monochrome mode, 2 for RGB565
+    int bytes_per_pixel() const { return bytes_per_pixel_; }
+    void *frame_buffer(int index) const { return frame_buffers_[index]; }
+    // Scans frame out from the next frame on; frame must be one of ours
+    void Present(const void *frame);
+    void SetFrameDoneCallback(FrameDoneFn fn, void *ctx);
+
+    // The panel's calibration, combined with the night mode white point
+    void SetCalibration(const ColorLut &lut);
+    // 6500 K or above for none
+    void SetWhitePoint(int kelvin);
+    // RGB565 colour of each luminance level in monochrome mode, before calibration and night
+    // mode; a grey ramp until set
+    void SetPalette(const uint16_t palette[256]);
+    // 256 steps from dark to light, the tint for a given full-luminance colour
+    static void RampPalette(uint16_t dark, uint16_t light, uint16_t palette[256]);
+
+    // Layer index goes over the frame buffer and the layers below it; one without pixels is
+    // removed. The surface the slot showed before may be reused once WaitLayersLatched returns.
+    static constexpr int kMaxLayers = 4;
+    void SetLayer(int index, const ScanoutLayer &layer);
+    bool layers_pending() const { return layers_pending_.load(std::memory_order_acquire); }
+    // Blocks until the last layer or ring change is on screen, woken by the frame boundary that
+    // latches it
+    void WaitLayersLatched();
+
+    // The ring window, changed together with the layers
+    void SetRing(const ScanoutRing &ring);
+    // Offset the ring window of frame_buffer is shown with, set before presenting it
+    void SetRingOffset(int frame_buffer, int offset);
+
+    ScanoutStats GetStats();
+    // Internal RAM of the two compiled LUTs the interrupt reads, on top of the frame buffers
+    static constexpr size_t lut_bytes() { return 2 * sizeof(CompiledLut); }
+
+private:
+    static constexpr int kMaxFrameBuffers = 3;
+    // Longer than a frame at the slowest refresh rate
+    static constexpr int kLayerLatchTimeoutMs = 50;
+
+    // ColorLut compiled for the fill loop: red and green looked up together from the top 11 bits.
+    // In monochrome mode the palette with the LUT already applied is used instead.
+    struct CompiledLut
+    {
+        bool identity;
+        uint16_t rg[2048];
+        uint16_t b[32];
+        uint16_t palette[256];
+    };
+
+    esp_lcd_panel_handle_t panel_;
+    int width_;
+    int height_;
+    size_t frame_pixels_;
+    int bytes_per_pixel_;
+    int num_fbs_ = 0;
+    uint8_t *frame_buffers_[kMaxFrameBuffers] = {nullptr, nullptr, nullptr};
+    int current_ = 0;
+    std::atomic<int> pending_{-1};
+
+    std::atomic<FrameDoneFn> frame_done_{nullptr};
+    void *frame_done_ctx_ = nullptr;
+
+    // The fill reads luts_[active_lut_]; a new table is compiled into the other one and swapped
+    // in at the frame boundary once lut_pending_ is set
+    CompiledLut *luts_ = nullptr;
+    int active_lut_ = 0;
+    std::atomic<bool> lut_pending_{false};
+    SemaphoreHandle_t lut_mutex_ = nullptr;
+    ColorLut calibration_;
+    int white_point_kelvin_ = 6500;
+    uint16_t palette_[256];
+
+    // Same scheme for the layers: layers_[active_layers_] is scanned out, a change is made to a
+    // copy in the other set
+    ScanoutLayer layers_[2][kMaxLayers];
+    ScanoutRing rings_[2];
+    std::atomic<int> ring_offsets_[kMaxFrameBuffers] = {};
+    int active_layers_ = 0;
+    std::atomic<bool> layers_pending_{false};
+    SemaphoreHandle_t layer_mutex_ = nullptr;
+    SemaphoreHandle_t layers_latched_ = nullptr;
+
+    // At 80 MHz the interrupt cannot keep up with per-pixel work, so the CPU is held at full speed
+    // while a LUT or palette lookup (guarded by lut_mutex_), or a layer or ring (by layer_mutex_)
+    // is in use. A plain RGB565 copy lets DFS lower the clock.
+    PmActivityLock pm_lock_{ESP_PM_CPU_FREQ_MAX, "scanout"};
+    bool lut_pm_held_ = false;
+    bool layers_pm_held_ = false;
+
+    portMUX_TYPE stats_lock_ = portMUX_INITIALIZER_UNLOCKED;
+    ScanoutStats stats_;
+
+    void CompileLut(CompiledLut *out) const;
+    void UpdateLut();
+    // Marks layer set next as pending, called with layer_mutex_ held
+    void CommitLayers(int next);
+    void FillPixels(const uint8_t *src, uint16_t *out, int count, const CompiledLut &lut) const;
+    void FillRing(uint16_t *bounce, int pos_px, int pixels, const CompiledLut &lut);
+    // The panel's on_bounce_empty callback, in IRAM like everything it calls
+    static bool OnBounceEmpty(esp_lcd_panel_handle_t panel, void *bounce_buf, int pos_px, int len_bytes,
+                              void *user_ctx);
+    bool FillBounce(void *bounce, int pos_px, int len_bytes);
+    bool FillLayers(uint16_t *bounce, int pos_px, int pixels, const CompiledLut &lut);
+};
+
+#endif // PANEL_SCANOUT_H
@@ -0,0 +1,280 @@
+#include "rgb565_blend.h"
+#include "band_scheduler.h"
+#include <sdkconfig.h>
+#include <esp_log.h>
+#include <cstddef>
+#include <cstring>
+
+#define TAG "Rgb565Blend"
+
+// Eight RGB565 pixels per 128-bit PIE register
+static constexpr int kBlockPixels = 8;
+
+#if CONFIG_IDF_TARGET_ESP32S3
+// Lane constants and buffers shared with rgb565_blend_esp32s3.S, offsets are fixed there
+struct alignas(16) Rgb565MixParams
+{
+    uint16_t k[9][kBlockPixels]; // opa, 4, 1, 31, 1, 63, 1, 32, 2048 in the order the kernel reads them
+    int32_t blocks;
+    int32_t scale_by_opa;
+    int32_t reserved[2];
+    uint16_t color[kBlockPixels]; // constant foreground
+    uint8_t opa[16];              // constant mix
+};
+static_assert(offsetof(Rgb565MixParams, blocks) == 144, "layout is shared with the assembly");
+static_assert(offsetof(Rgb565MixParams, color) == 160, "layout is shared with the assembly");
+
+// rgb565_blend_esp32s3.S. dst must be 16-byte aligned, blocks are 8 pixels. Streams read with
+// a non-zero step may be read up to 16 bytes past their last used byte.
+extern "C" void rgb565_fill_row_pie(uint16_t *dst, const uint16_t *color8, int blocks);
+extern "C" void rgb565_copy_row_pie(uint16_t *dst, const uint16_t *src, int blocks);
+// fg_step is 0 (constant colour) or 16, mix_step 0 (constant opa) or 8 bytes per block
+extern "C" void rgb565_mix_row_pie(uint16_t *dst, const uint16_t *fg, int fg_step, const uint8_t *mix, int mix_step,
+                                   const Rgb565MixParams *params);
+#endif
+
+// lv_color_16_16_mix: all three channels are mixed at once in one 32-bit word, with green moved
+// to the upper half so every channel has room for the product
+static inline uint16_t Mix(uint16_t fg, uint16_t bg, uint8_t mix)
+{
+    if (mix == 255)
+    {
+        return fg;
+    }
+    if (mix == 0 || fg == bg)
+    {
+        return mix == 0 ? bg : fg;
+    }
+    const uint32_t m = (mix + 4u) >> 3;
+    const uint32_t b = (bg | (static_cast<uint32_t>(bg) << 16)) & 0x7E0F81F;
+    const uint32_t f = (fg | (static_cast<uint32_t>(fg) << 16)) & 0x7E0F81F;
+    const uint32_t result = ((((f - b) * m) >> 5) + b) & 0x7E0F81F;
+    return static_cast<uint16_t>((result >> 16) | result);
+}
+
+// One row: the foreground is src[x] or color, the mix mask[x], mask[x] * opa >> 8 or opa
+static void BlendRowScalar(uint16_t *dst, int n, const uint16_t *src, uint16_t color, const uint8_t *mask, uint8_t opa)
+{
+    if (mask == nullptr && opa == 255)
+    {
+        if (src != nullptr)
+        {
+            memcpy(dst, src, n * sizeof(uint16_t));
+        }
+        else
+        {
+            for (int x = 0; x < n; x++)
+            {
+                dst[x] = color;
+            }
+        }
+        return;
+    }
+    for (int x = 0; x < n; x++)
+    {
+        uint8_t mix = mask == nullptr ? opa : opa == 255 ? mask[x] : static_cast<uint8_t>((mask[x] * opa) >> 8);
+        dst[x] = Mix(src != nullptr ? src[x] : color, dst[x], mix);
+    }
+}
+
+#if CONFIG_IDF_TARGET_ESP32S3
+static void FillParams(Rgb565MixParams &params, uint16_t color, uint8_t opa, bool scale_by_opa)
+{
+    static constexpr uint16_t kLaneConstants[9] = {0, 4, 1, 31, 1, 63, 1, 32, 2048};
+    for (int i = 0; i < 9; i++)
+    {
+        for (int j = 0; j < kBlockPixels; j++)
+        {
+            params.k[i][j] = i == 0 ? opa : kLaneConstants[i];
+        }
+    }
+    for (int j = 0; j < kBlockPixels; j++)
+    {
+        params.color[j] = color;
+    }
+    memset(params.opa, opa, sizeof(params.opa));
+    params.blocks = 0;
+    params.scale_by_opa = scale_by_opa;
+}
+
+static bool PieAvailable()
+{
+    // Check the vector path against the scalar one once before trusting it, on colours and
+    // mix values that cover every rounding case of the channel arithmetic
+    static const bool available = []()
+    {
+        constexpr int kPixels = 64;
+        alignas(16) uint16_t src[kPixels + 16];
+        alignas(16) uint16_t expected[kPixels];
+        alignas(16) uint16_t actual[kPixels];
+        alignas(16) uint8_t mask[kPixels + 32];
+        for (int i = 0; i < kPixels + 16; i++)
+        {
+            src[i] = static_cast<uint16_t>(i * 40503u + 0x1234);
+        }
+        for (int i = 0; i < kPixels + 32; i++)
+        {
+            mask[i] = static_cast<uint8_t>(i * 37 + 1);
+        }
+        static constexpr uint8_t kOpas[] = {255, 200, 3};
+        bool ok = true;
+        for (uint8_t opa : kOpas)
+        {
+            Rgb565MixParams params;
+            FillParams(params, 0, opa, opa != 255);
+            params.blocks = kPixels / kBlockPixels;
+            for (int i = 0; i < kPixels; i++)
+            {
+                expected[i] = actual[i] = static_cast<uint16_t>(0xFFFF - i * 1021u);
+            }
+            BlendRowScalar(expected, kPixels, src + 1, 0, mask + 3, opa);
+            rgb565_mix_row_pie(actual, src + 1, 16, mask + 3, 8, &params);
+            ok = ok && memcmp(expected, actual, sizeof(actual)) == 0;
+        }
+        if (!ok)
+        {
+            ESP_LOGW(TAG, "PIE blend self-check failed, using scalar blending");
+        }
+        return ok;
+    }();
+    return available;
+}
+
+// Pixels before the first 16-byte aligned destination pixel and vector blocks after it. Streams
+// with a step keep 16 pixels for the scalar tail, so the over-read stays inside the row.
+static void SplitRow(const uint16_t *dst, int n, bool streams, int &head, int &blocks)
+{
+    head = static_cast<int>(((16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15) / sizeof(uint16_t));
+    if (head > n)
+    {
+        head = n;
+    }
+    int body = n - head - (streams ? 16 : 0);
+    blocks = body > 0 ? body / kBlockPixels : 0;
+}
+#endif
+
+static void BlendRows(uint16_t *dst, int w, int h, int dst_stride, const uint16_t *src, int src_stride, uint16_t color,
+                      const uint8_t *mask, int mask_stride, uint8_t opa, [[maybe_unused]] bool use_simd)
+{
+    auto next_row = [](auto *row, int stride)
+    { return reinterpret_cast<decltype(row)>(reinterpret_cast<uintptr_t>(row) + stride); };
+
+#if CONFIG_IDF_TARGET_ESP32S3
+    if (use_simd && PieAvailable())
+    {
+        Rgb565MixParams params;
+        FillParams(params, color, opa, mask != nullptr && opa != 255);
+        const bool copy = mask == nullptr && opa == 255;
+        const bool streams = src != nullptr || mask != nullptr;
+        for (int y = 0; y < h; y++)
+        {
+            int head, blocks;
+            SplitRow(dst, w, streams, head, blocks);
+            BlendRowScalar(dst, head, src, color, mask, opa);
+            uint16_t *body = dst + head;
+            if (blocks > 0)
+            {
+                const uint16_t *fg = src != nullptr ? src + head : params.color;
+                if (copy && src != nullptr)
+                {
+                    rgb565_copy_row_pie(body, fg, blocks);
+                }
+                else if (copy)
+                {
+                    rgb565_fill_row_pie(body, params.color, blocks);
+                }
+                else
+                {
+                    params.blocks = blocks;
+                    rgb565_mix_row_pie(body, fg, src != nullptr ? 16 : 0, mask != nullptr ? mask + head : params.opa,
+                                       mask != nullptr ? 8 : 0, &params);
+                }
+            }
+            const int done = head + blocks * kBlockPixels;
+            BlendRowScalar(dst + done, w - done, src != nullptr ? src + done : nullptr, color,
+                           mask != nullptr ? mask + done : nullptr, opa);
+
+            dst = next_row(dst, dst_stride);
+            src = src != nullptr ? next_row(src, src_stride) : nullptr;
+            mask = mask != nullptr ? next_row(mask, mask_stride) : nullptr;
+        }
+        return;
+    }
+#endif
+
+    for (int y = 0; y < h; y++)
+    {
+        BlendRowScalar(dst, w, src, color, mask, opa);
+        dst = next_row(dst, dst_stride);
+        src = src != nullptr ? next_row(src, src_stride) : nullptr;
+        mask = mask != nullptr ? next_row(mask, mask_stride) : nullptr;
+    }
+}
+
+// Areas from this size up are split into row bands for both cores, below that waking the helper
+// costs more than it saves
+static constexpr int kParallelMinPixels = 8 * 1024;
+static constexpr int kParallelBandPixels = 2 * 1024;
+
+struct BlendJob
+{
+    uint16_t *dst;
+    int w;
+    int dst_stride;
+    const uint16_t *src;
+    int src_stride;
+    uint16_t color;
+    const uint8_t *mask;
+    int mask_stride;
+    uint8_t opa;
+    bool use_simd;
+};
+
+static void BlendBand(void *ctx, int first, int end)
+{
+    const auto &job = *static_cast<const BlendJob *>(ctx);
+    auto row = [first](auto *base, int stride)
+    { return base != nullptr ? reinterpret_cast<decltype(base)>(reinterpret_cast<uintptr_t>(base) + first * stride) : base; };
+    BlendRows(row(job.dst, job.dst_stride), job.w, end - first, job.dst_stride, row(job.src, job.src_stride),
+              job.src_stride, job.color, row(job.mask, job.mask_stride), job.mask_stride, job.opa, job.use_simd);
+}
+
+// The dispatched entry points split large areas across both cores, the scalar ones stay on the
+// calling core as the single-threaded reference
+static void Blend(uint16_t *dst, int w, int h, int dst_stride, const uint16_t *src, int src_stride, uint16_t color,
+                  const uint8_t *mask, int mask_stride, uint8_t opa, bool use_simd)
+{
+    if (!use_simd || w * h < kParallelMinPixels || h < 2)
+    {
+        BlendRows(dst, w, h, dst_stride, src, src_stride, color, mask, mask_stride, opa, use_simd);
+        return;
+    }
+    BlendJob job = {dst, w, dst_stride, src, src_stride, color, mask, mask_stride, opa, use_simd};
+    const int band_rows = kParallelBandPixels / w > 0 ? kParallelBandPixels / w : 1;
+    BandScheduler::GetInstance().Run(h, band_rows, BlendBand, &job);
+}
+
+void rgb565_fill(uint16_t *dst, int w, int h, int dst_stride, uint16_t color, const uint8_t *mask, int mask_stride,
+                 uint8_t opa)
+{
+    Blend(dst, w, h, dst_stride, nullptr, 0, color, mask, mask_stride, opa, true);
+}
+
+void rgb565_blend_image(uint16_t *dst, int w, int h, int dst_stride, const uint16_t *src, int src_stride,
+                        const uint8_t *mask, int mask_stride, uint8_t opa)
+{
+    Blend(dst, w, h, dst_stride, src, src_stride, 0, mask, mask_stride, opa, true);
+}
+
+void rgb565_fill_scalar(uint16_t *dst, int w, int h, int dst_stride, uint16_t color, const uint8_t *mask,
+                        int mask_stride, uint8_t opa)
+{
+    Blend(dst, w, h, dst_stride, nullptr, 0, color, mask, mask_stride, opa, false);
+}
+
+void rgb565_blend_image_scalar(uint16_t *dst, int w, int h, int dst_stride, const uint16_t *src, int src_stride,
+                               const uint8_t *mask, int mask_stride, uint8_t opa)
+{
+    Blend(dst, w, h, dst_stride, src, src_stride, 0, mask, mask_stride, opa, false);
+}
@@ -0,0 +1,31 @@
+#ifndef RGB565_BLEND_H
+#define RGB565_BLEND_H
+
+#include <cstdint>
+
+// RGB565 fill and blend kernels behind LVGL's software renderer (see rgb565_blend_lvgl.h).
+//
+// Results are bit-exact with LVGL's lv_draw_sw_blend_to_rgb565.c: a pixel is mixed as
+// lv_color_16_16_mix(fg, bg, mix) with mix = mask, mask * opa >> 8 or opa, so the vector and
+// scalar paths can be swapped freely. Strides are in bytes, like LVGL's blend descriptors.
+// opa 255 means "not faded"; a null mask means every mask value is 255.
+// On ESP32-S3 each row is processed eight pixels at a time with PIE vector instructions from the
+// first 16-byte aligned destination pixel; the rest of the row takes the scalar path. Large areas
+// are split into row bands rendered on both cores (band_scheduler.h).
+
+void rgb565_fill(uint16_t *dst, int w, int h, int dst_stride, uint16_t color, const uint8_t *mask, int mask_stride,
+                 uint8_t opa);
+void rgb565_blend_image(uint16_t *dst, int w, int h, int dst_stride, const uint16_t *src, int src_stride,
+                        const uint8_t *mask, int mask_stride, uint8_t opa);
+
+// Plain C++ implementations, used as fallback and reference
+void rgb565_fill_scalar(uint16_t *dst, int w, int h, int dst_stride, uint16_t color, const uint8_t *mask,
+                        int mask_stride, uint8_t opa);
+void rgb565_blend_image_scalar(uint16_t *dst, int w, int h, int dst_stride, const uint16_t *src, int src_stride,
+                               const uint8_t *mask, int mask_stride, uint8_t opa);
+
+// Check the kernels against LVGL's own software blend loops and log their throughput in MB/s,
+// returns the number of failed checks
+int Rgb565BlendBenchmark();
+
+#endif // RGB565_BLEND_H
@@ -0,0 +1,183 @@
+#include "rgb565_blend.h"
+#include "bench_util.h"
+#include <lvgl.h>
+#include <lvgl_private.h>
+#include "rgb565_blend_lvgl.h"
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <cstring>
+
+#define TAG "BlendBench"
+
+enum class BenchKernel
+{
+    kFill,
+    kImage,
+};
+
+struct BenchCase
+{
+    const char *name;
+    BenchKernel kernel;
+    int width;
+    int height;
+    bool masked;
+    uint8_t opa;
+    uint32_t dst_caps; // where LVGL would be rendering
+};
+
+// What LVGL draws on this UI: backgrounds, faded panels, anti-aliased glyphs and images
+static const BenchCase kBenchCases[] = {
+    {"screen fill", BenchKernel::kFill, 960, 376, false, 255, MALLOC_CAP_SPIRAM},
+    {"faded band", BenchKernel::kFill, 960, 16, false, 128, MALLOC_CAP_INTERNAL},
+    {"glyphs", BenchKernel::kFill, 200, 32, true, 255, MALLOC_CAP_INTERNAL},
+    {"faded glyphs", BenchKernel::kFill, 200, 32, true, 160, MALLOC_CAP_INTERNAL},
+    {"image copy", BenchKernel::kImage, 200, 100, false, 255, MALLOC_CAP_INTERNAL},
+    {"faded image", BenchKernel::kImage, 200, 100, false, 128, MALLOC_CAP_INTERNAL},
+    {"masked image", BenchKernel::kImage, 123, 37, true, 200, MALLOC_CAP_INTERNAL},
+};
+
+static constexpr uint16_t kFillColor = 0x4A69;
+
+// Blends the case through LVGL's software renderer (lv_draw_sw_blend) into rows of stride_px
+// pixels, starting at column offset. With the hooks of rgb565_blend_lvgl.h disabled this is
+// LVGL's own loops, the reference; enabled it is the dispatched kernels as LVGL calls them.
+static void LvglBlend(const BenchCase &c, bool hooks, uint16_t *dst, int stride_px, int offset, const uint16_t *src,
+                      const uint8_t *mask)
+{
+    lv_draw_buf_t buf;
+    lv_draw_buf_init(&buf, stride_px, c.height, LV_COLOR_FORMAT_RGB565, stride_px * 2, dst, stride_px * c.height * 2);
+    lv_layer_t layer = {};
+    layer.draw_buf = &buf;
+    layer.color_format = LV_COLOR_FORMAT_RGB565;
+    layer.buf_area = {0, 0, stride_px - 1, c.height - 1};
+    lv_area_t clip = layer.buf_area;
+    lv_draw_unit_t unit = {};
+    unit.target_layer = &layer;
+    unit.clip_area = &clip;
+
+    const lv_area_t area = {offset, 0, offset + c.width - 1, c.height - 1};
+    lv_draw_sw_blend_dsc_t dsc = {};
+    dsc.blend_area = &area;
+    dsc.opa = c.opa;
+    dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+    if (c.masked)
+    {
+        dsc.mask_buf = mask;
+        dsc.mask_area = &area;
+        dsc.mask_stride = c.width;
+        dsc.mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
+    }
+    if (c.kernel == BenchKernel::kFill)
+    {
+        dsc.color = lv_color_make((kFillColor >> 11) << 3, ((kFillColor >> 5) & 0x3F) << 2, (kFillColor & 0x1F) << 3);
+    }
+    else
+    {
+        dsc.src_buf = src;
+        dsc.src_stride = c.width * 2;
+        dsc.src_color_format = LV_COLOR_FORMAT_RGB565;
+        dsc.src_area = &area;
+    }
+
+    rgb565_lv_blend_set_enabled(hooks);
+    lv_draw_sw_blend(&unit, &dsc);
+    rgb565_lv_blend_set_enabled(true);
+}
+
+static void Run(const BenchCase &c, bool scalar, uint16_t *dst, int stride_px, const uint16_t *src, const uint8_t *mask)
+{
+    const int mask_stride = c.masked ? c.width : 0;
+    const uint8_t *m = c.masked ? mask : nullptr;
+    if (c.kernel == BenchKernel::kFill)
+    {
+        (scalar ? rgb565_fill_scalar : rgb565_fill)(dst, c.width, c.height, stride_px * 2, kFillColor, m, mask_stride,
+                                                    c.opa);
+    }
+    else
+    {
+        (scalar ? rgb565_blend_image_scalar : rgb565_blend_image)(dst, c.width, c.height, stride_px * 2, src,
+                                                                  c.width * 2, m, mask_stride, c.opa);
+    }
+}
+
+static double MeasureMBps(const BenchCase &c, bool scalar, uint16_t *dst, const uint16_t *src, const uint8_t *mask)
+{
+    const double us = BenchMeasureUs([&] { Run(c, scalar, dst, c.width, src, mask); });
+    return c.width * c.height * 2 / us; // bytes per microsecond == MB/s
+}
+
+int Rgb565BlendBenchmark()
+{
+    // Before the board has brought LVGL up only the blend code is needed, lvgl_port_init then
+    // finds it initialised
+    if (!lv_is_initialized())
+    {
+        lv_init();
+    }
+
+    int failures = 0;
+    for (const auto &c : kBenchCases)
+    {
+        // Rows one pixel wider than the area, which is then drawn at either column
+        const int stride_px = c.width + 1;
+        const size_t dst_bytes = stride_px * c.height * 2;
+        const size_t src_pixels = c.width * c.height;
+        auto dst = static_cast<uint16_t *>(heap_caps_aligned_alloc(16, dst_bytes, c.dst_caps));
+        auto ref = static_cast<uint16_t *>(heap_caps_aligned_alloc(16, dst_bytes, c.dst_caps));
+        auto src = static_cast<uint16_t *>(heap_caps_aligned_alloc(16, src_pixels * 2, MALLOC_CAP_INTERNAL));
+        auto mask = static_cast<uint8_t *>(heap_caps_aligned_alloc(16, src_pixels, MALLOC_CAP_INTERNAL));
+        if (dst == nullptr || ref == nullptr || src == nullptr || mask == nullptr)
+        {
+            ESP_LOGE(TAG, "%s: failed to allocate buffers", c.name);
+            heap_caps_free(dst);
+            heap_caps_free(ref);
+            heap_caps_free(src);
+            heap_caps_free(mask);
+            failures++;
+            continue;
+        }
+        for (size_t i = 0; i < src_pixels; i++)
+        {
+            src[i] = static_cast<uint16_t>(i * 2654435761u >> 16);
+            // Mostly fully covered or empty like glyph masks, with edges in between
+            uint32_t r = i * 40503u >> 8;
+            mask[i] = (r & 3) == 0 ? 0 : (r & 3) == 1 ? 255 : static_cast<uint8_t>(r >> 2);
+        }
+
+        // The kernels behind LVGL's blend and the scalar path on their own must both give what
+        // LVGL's loops give, aligned and misaligned by one pixel
+        bool match = true;
+        for (int offset = 0; offset < 2; offset++)
+        {
+            for (int path = 0; path < 2; path++)
+            {
+                for (size_t i = 0; i < dst_bytes / 2; i++)
+                {
+                    dst[i] = ref[i] = static_cast<uint16_t>(i * 7919u);
+                }
+                LvglBlend(c, false, ref, stride_px, offset, src, mask);
+                if (path == 0)
+                {
+                    LvglBlend(c, true, dst, stride_px, offset, src, mask);
+                }
+                else
+                {
+                    Run(c, true, dst + offset, stride_px, src, mask);
+                }
+                match = match && BenchMatches(TAG, c.name, dst, ref, dst_bytes / 2);
+            }
+        }
+        failures += match ? 0 : 1;
+
+        double scalar = MeasureMBps(c, true, dst, src, mask);
+        double fast = MeasureMBps(c, false, dst, src, mask);
+        ESP_LOGI(TAG, "%-13s %4dx%-4d scalar %7.1f MB/s, dispatched %7.1f MB/s (x%.2f)",
+                 c.name, c.width, c.height, scalar, fast, fast / scalar);
+        heap_caps_free(dst);
+        heap_caps_free(ref);
+        heap_caps_free(src);
+        heap_caps_free(mask);
+    }
+    return failures;
+}
@@ -0,0 +1,39 @@
+#include <lvgl.h>
+#include <lvgl_private.h>
+#include "rgb565_blend_lvgl.h"
+#include "rgb565_blend.h"
+
+// LVGL has already picked the branch from mask_buf and opa, opacities from LV_OPA_MAX up count as
+// fully opaque there, so they do here too
+
+static bool hooks_enabled = true;
+
+void rgb565_lv_blend_set_enabled(bool enabled)
+{
+    hooks_enabled = enabled;
+}
+
+lv_result_t rgb565_lv_blend_color(struct _lv_draw_sw_blend_fill_dsc_t *dsc)
+{
+    if (!hooks_enabled)
+    {
+        return LV_RESULT_INVALID;
+    }
+    const uint8_t opa = dsc->opa >= LV_OPA_MAX ? 255 : dsc->opa;
+    rgb565_fill(static_cast<uint16_t *>(dsc->dest_buf), dsc->dest_w, dsc->dest_h, dsc->dest_stride,
+                lv_color_to_u16(dsc->color), dsc->mask_buf, dsc->mask_stride, opa);
+    return LV_RESULT_OK;
+}
+
+lv_result_t rgb565_lv_blend_rgb565(struct _lv_draw_sw_blend_image_dsc_t *dsc)
+{
+    if (!hooks_enabled)
+    {
+        return LV_RESULT_INVALID;
+    }
+    const uint8_t opa = dsc->opa >= LV_OPA_MAX ? 255 : dsc->opa;
+    rgb565_blend_image(static_cast<uint16_t *>(dsc->dest_buf), dsc->dest_w, dsc->dest_h, dsc->dest_stride,
+                       static_cast<const uint16_t *>(dsc->src_buf), dsc->src_stride, dsc->mask_buf,
+                       dsc->mask_stride, opa);
+    return LV_RESULT_OK;
+}
@@ -0,0 +1,40 @@
+/**
+ * LVGL's custom software blend hooks (LV_USE_DRAW_SW_ASM = LV_DRAW_SW_ASM_CUSTOM), included by
+ * lv_draw_sw_blend_to_rgb565.c through LV_DRAW_SW_ASM_CUSTOM_INCLUDE.
+ *
+ * Every solid fill, faded fill, masked fill (anti-aliased edges, A8 glyphs) and RGB565 image blend
+ * the software renderer produces for an RGB565 target goes through rgb565_blend.h. Blends from
+ * other source formats keep LVGL's own loops.
+ */
+#ifndef RGB565_BLEND_LVGL_H
+#define RGB565_BLEND_LVGL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct _lv_draw_sw_blend_fill_dsc_t;
+struct _lv_draw_sw_blend_image_dsc_t;
+
+lv_result_t rgb565_lv_blend_color(struct _lv_draw_sw_blend_fill_dsc_t *dsc);
+lv_result_t rgb565_lv_blend_rgb565(struct _lv_draw_sw_blend_image_dsc_t *dsc);
+
+/* While disabled the hooks return LV_RESULT_INVALID and LVGL blends with its own loops, which the
+ * blend benchmark renders as the reference for the kernels */
+void rgb565_lv_blend_set_enabled(bool enabled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc) rgb565_lv_blend_color(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc) rgb565_lv_blend_color(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc) rgb565_lv_blend_color(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc) rgb565_lv_blend_color(dsc)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565(dsc) rgb565_lv_blend_rgb565(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc) rgb565_lv_blend_rgb565(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc) rgb565_lv_blend_rgb565(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc) rgb565_lv_blend_rgb565(dsc)
+
+#endif // RGB565_BLEND_LVGL_H
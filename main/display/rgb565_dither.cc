@@ -0,0 +1,79 @@
+#include "rgb565_dither.h"
+#include <esp_attr.h>
+#include <algorithm>
+
+// 4x4 Bayer matrix, thresholds 0..15
+static constexpr uint8_t kBayer[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+// The same thresholds scaled to each channel's step and laid out as the byte lanes of an XRGB8888
+// word: 0..7 for red and blue (8 per 5-bit step), 0..3 for green (4 per 6-bit step). Read from
+// the bounce interrupt, so kept out of flash.
+struct DitherRows
+{
+    uint32_t lanes[4][4];
+};
+
+static constexpr DitherRows MakeDitherRows()
+{
+    DitherRows rows = {};
+    for (int y = 0; y < 4; y++)
+    {
+        for (int x = 0; x < 4; x++)
+        {
+            const uint32_t m = kBayer[y][x];
+            rows.lanes[y][x] = (m >> 1) << 16 | (m >> 2) << 8 | (m >> 1);
+        }
+    }
+    return rows;
+}
+
+DRAM_ATTR static const DitherRows kDitherRows = MakeDitherRows();
+
+// Per-lane saturating add of the threshold, then the top 5/6/5 bits of each lane
+static inline IRAM_ATTR uint32_t DitherPixel(uint32_t p, uint32_t t)
+{
+    p &= 0x00FFFFFF;
+    const uint32_t sum = ((p & 0x7F7F7F) + t) ^ (p & 0x808080);
+    const uint32_t carry = p & ~sum & 0x808080;
+    const uint32_t s = sum | (carry - (carry >> 7)) | carry;
+    return ((s >> 8) & 0xF800) | ((s >> 5) & 0x07E0) | ((s >> 3) & 0x001F);
+}
+
+IRAM_ATTR void xrgb8888_to_rgb565_dither(const uint32_t *src, uint16_t *dst, int count, int x, int y)
+{
+    const uint32_t *row = kDitherRows.lanes[y & 3];
+    int i = 0;
+    if (count > 0 && (reinterpret_cast<uintptr_t>(dst) & 2) != 0)
+    {
+        dst[0] = static_cast<uint16_t>(DitherPixel(src[0], row[x & 3]));
+        i = 1;
+    }
+    auto *out = reinterpret_cast<uint32_t *>(dst + i);
+    for (; i + 1 < count; i += 2)
+    {
+        const uint32_t lo = DitherPixel(src[i], row[(x + i) & 3]);
+        const uint32_t hi = DitherPixel(src[i + 1], row[(x + i + 1) & 3]);
+        *out++ = lo | hi << 16;
+    }
+    if (i < count)
+    {
+        dst[i] = static_cast<uint16_t>(DitherPixel(src[i], row[(x + i) & 3]));
+    }
+}
+
+void xrgb8888_to_rgb565_dither_scalar(const uint32_t *src, uint16_t *dst, int count, int x, int y)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const int m = kBayer[y & 3][(x + i) & 3];
+        const int r = std::min(255, static_cast<int>(src[i] >> 16 & 0xFF) + (m >> 1));
+        const int g = std::min(255, static_cast<int>(src[i] >> 8 & 0xFF) + (m >> 2));
+        const int b = std::min(255, static_cast<int>(src[i] & 0xFF) + (m >> 1));
+        dst[i] = static_cast<uint16_t>((r >> 3) << 11 | (g >> 2) << 5 | (b >> 3));
+    }
+}
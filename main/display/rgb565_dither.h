@@ -0,0 +1,24 @@
+#ifndef RGB565_DITHER_H
+#define RGB565_DITHER_H
+
+#include <cstdint>
+
+// XRGB8888 to RGB565 with a 4x4 ordered (Bayer) dither, for surfaces rendered at 8 bits per
+// channel that would band when truncated: gradients, photos.
+//
+// Each channel gets the Bayer threshold scaled to its quantisation step added, saturating at 255,
+// before it is truncated to 5/6/5 bits. x and y are the panel position of the first pixel, so
+// the pattern stays put from frame to frame and does not shimmer. Both paths give identical
+// results; the dispatched one treats a pixel as three byte lanes of one word and handles two
+// pixels per 32-bit store. It runs from the bounce buffer interrupt, so it stays out of PIE,
+// whose state is only saved for tasks.
+void xrgb8888_to_rgb565_dither(const uint32_t *src, uint16_t *dst, int count, int x, int y);
+
+// Plain per-channel implementation, the fallback
+void xrgb8888_to_rgb565_dither_scalar(const uint32_t *src, uint16_t *dst, int count, int x, int y);
+
+// Check both paths against an independent reference built on LVGL's RGB565 conversion and log
+// the cost of one panel line, returns the number of failed checks
+int Rgb565DitherBenchmark();
+
+#endif // RGB565_DITHER_H
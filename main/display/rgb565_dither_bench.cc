@@ -0,0 +1,117 @@
+#include "rgb565_dither.h"
+#include "bench_util.h"
+#include <lvgl.h>
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <algorithm>
+#include <cstring>
+
+#define TAG "DitherBench"
+
+// One panel line, read from where a layer surface would live and written to a bounce buffer
+static constexpr int kLinePixels = 376;
+static constexpr int kLinesPerFrame = 960;
+
+struct BenchCase
+{
+    const char *name;
+    uint32_t src_caps;
+};
+
+// Full line, odd length, single pixel
+static const int kCounts[] = {kLinePixels, kLinePixels - 1, 1};
+
+static const BenchCase kBenchCases[] = {
+    {"internal", MALLOC_CAP_INTERNAL},
+    {"psram", MALLOC_CAP_SPIRAM},
+};
+
+// 4x4 Bayer threshold 0..15 from its closed form, the bit-reversed interleave of y and x ^ y,
+// rather than the table the kernels use
+static int BayerThreshold(int x, int y)
+{
+    const int d = (x ^ y) & 3;
+    return (d & 1) << 3 | (y & 1) << 2 | (d & 2) | (y >> 1 & 1);
+}
+
+// The dither as specified: each channel raised by the threshold scaled to its quantisation step
+// (8 for 5 bits, 4 for 6 bits) and clamped, then converted with LVGL's RGB888 to RGB565
+static void ReferenceDither(const uint32_t *src, uint16_t *dst, int count, int x, int y)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const int m = BayerThreshold(x + i, y);
+        const int r = std::min(255, static_cast<int>(src[i] >> 16 & 0xFF) + m * 8 / 16);
+        const int g = std::min(255, static_cast<int>(src[i] >> 8 & 0xFF) + m * 4 / 16);
+        const int b = std::min(255, static_cast<int>(src[i] & 0xFF) + m * 8 / 16);
+        dst[i] = lv_color_to_u16(lv_color_make(r, g, b));
+    }
+}
+
+static double MeasureLineUs(bool scalar, const uint32_t *src, uint16_t *dst)
+{
+    int line = 0;
+    return BenchMeasureUs([&]
+    {
+        (scalar ? xrgb8888_to_rgb565_dither_scalar : xrgb8888_to_rgb565_dither)(src, dst, kLinePixels, 0, line++);
+    });
+}
+
+int Rgb565DitherBenchmark()
+{
+    int failures = 0;
+    for (const auto &c : kBenchCases)
+    {
+        // A pixel longer than a line, so the line can also be written from the second one
+        auto src = static_cast<uint32_t *>(heap_caps_aligned_alloc(16, kLinePixels * 4, c.src_caps));
+        auto dst = static_cast<uint16_t *>(heap_caps_aligned_alloc(16, (kLinePixels + 1) * 2, MALLOC_CAP_INTERNAL));
+        auto ref = static_cast<uint16_t *>(heap_caps_aligned_alloc(16, (kLinePixels + 1) * 2, MALLOC_CAP_INTERNAL));
+        if (src == nullptr || dst == nullptr || ref == nullptr)
+        {
+            ESP_LOGE(TAG, "%s: failed to allocate buffers", c.name);
+            heap_caps_free(src);
+            heap_caps_free(dst);
+            heap_caps_free(ref);
+            failures++;
+            continue;
+        }
+        for (int i = 0; i < kLinePixels; i++)
+        {
+            // Random colours with the lanes near 255 well represented, where the add saturates
+            uint32_t p = i * 2654435761u;
+            src[i] = (i & 7) == 0 ? p | 0xF8FCF8 : p;
+        }
+
+        // Both paths at every phase of the pattern, with the destination aligned and misaligned by
+        // one pixel
+        bool match = true;
+        for (int phase = 0; phase < 16; phase++)
+        {
+            for (int offset = 0; offset < 2; offset++)
+            {
+                for (int count : kCounts)
+                {
+                    for (int scalar = 0; scalar < 2; scalar++)
+                    {
+                        memset(dst, 0x5A, (kLinePixels + 1) * 2);
+                        memset(ref, 0x5A, (kLinePixels + 1) * 2);
+                        ReferenceDither(src, ref + offset, count, phase & 3, phase >> 2);
+                        (scalar ? xrgb8888_to_rgb565_dither_scalar : xrgb8888_to_rgb565_dither)(
+                            src, dst + offset, count, phase & 3, phase >> 2);
+                        match = match && BenchMatches(TAG, c.name, dst, ref, kLinePixels + 1);
+                    }
+                }
+            }
+        }
+        failures += match ? 0 : 1;
+
+        double scalar = MeasureLineUs(true, src, dst);
+        double fast = MeasureLineUs(false, src, dst);
+        ESP_LOGI(TAG, "%-8s line of %d: scalar %6.2f us, dispatched %6.2f us (x%.2f), %.2f ms per frame", c.name,
+                 kLinePixels, scalar, fast, scalar / fast, fast * kLinesPerFrame / 1000);
+        heap_caps_free(src);
+        heap_caps_free(dst);
+        heap_caps_free(ref);
+    }
+    return failures;
+}
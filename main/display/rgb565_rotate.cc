@@ -0,0 +1,134 @@
+#include "rgb565_rotate.h"
+#include <sdkconfig.h>
+#include <esp_log.h>
+#include <cstddef>
+#include <cstring>
+
+#define TAG "Rgb565Rotate"
+
+// 32x32 pixel tiles keep 2 KB of source and 2 KB of destination rows hot in the
+// 32 KB data cache while the PSRAM frame buffer is written column by column
+static constexpr int kTileSize = 32;
+static constexpr int kBlockSize = 8;
+
+#if CONFIG_IDF_TARGET_ESP32S3
+// rgb565_rotate_esp32s3.S: transpose one 8x8 block. Rows are loaded from src,
+// src + src_step, ... and written to dst, dst + dst_step, ... (steps in bytes,
+// may be negative). All row addresses must be 16-byte aligned.
+extern "C" void rgb565_transpose_8x8_pie(const uint16_t *src, int src_step, uint16_t *dst, int dst_step);
+#endif
+
+// out_row[j][i] = in_row[i][j] with in_row[i] = src + i * src_step, out_row[j] = dst + j * dst_step
+template <typename Pixel>
+static inline void TransposeBlockScalar(const Pixel *src, ptrdiff_t src_step, Pixel *dst, ptrdiff_t dst_step,
+                                        int rows, int cols)
+{
+    for (int i = 0; i < rows; i++)
+    {
+        const Pixel *in = src + i * src_step;
+        for (int j = 0; j < cols; j++)
+        {
+            dst[j * dst_step + i] = in[j];
+        }
+    }
+}
+
+static bool PieAvailable()
+{
+#if CONFIG_IDF_TARGET_ESP32S3
+    // Check the vector path against the scalar one once before trusting it
+    static const bool available = []()
+    {
+        alignas(16) uint16_t src[kBlockSize * kBlockSize];
+        alignas(16) uint16_t expected[kBlockSize * kBlockSize];
+        alignas(16) uint16_t actual[kBlockSize * kBlockSize];
+        for (int i = 0; i < kBlockSize * kBlockSize; i++)
+        {
+            src[i] = static_cast<uint16_t>(i * 0x0101 + 7);
+        }
+        TransposeBlockScalar(src, kBlockSize, expected, kBlockSize, kBlockSize, kBlockSize);
+        rgb565_transpose_8x8_pie(src, kBlockSize * 2, actual, kBlockSize * 2);
+        bool ok = memcmp(expected, actual, sizeof(actual)) == 0;
+        if (!ok)
+        {
+            ESP_LOGW(TAG, "PIE transpose self-check failed, using scalar rotation");
+        }
+        return ok;
+    }();
+    return available;
+#else
+    return false;
+#endif
+}
+
+template <typename Pixel>
+static void Rotate(const Pixel *src, int w, int h, int src_stride,
+                   Pixel *dst, int dst_stride, bool mirror_x, bool mirror_y, bool use_simd)
+{
+    // A run of source rows maps to a contiguous run of destination columns.
+    // With mirror_x the run is reversed, so rows are fed from the bottom up;
+    // with mirror_y the destination rows are written from the bottom up.
+    const ptrdiff_t src_step = mirror_x ? -src_stride : src_stride;
+    const ptrdiff_t dst_step = mirror_y ? -dst_stride : dst_stride;
+    use_simd = use_simd && PieAvailable();
+
+    for (int ty = 0; ty < h; ty += kTileSize)
+    {
+        const int tile_h = (h - ty < kTileSize) ? h - ty : kTileSize;
+        for (int tx = 0; tx < w; tx += kTileSize)
+        {
+            const int tile_w = (w - tx < kTileSize) ? w - tx : kTileSize;
+            for (int by = ty; by < ty + tile_h; by += kBlockSize)
+            {
+                const int rows = (ty + tile_h - by < kBlockSize) ? ty + tile_h - by : kBlockSize;
+                const int first_row = mirror_x ? by + rows - 1 : by;
+                const int first_col = mirror_x ? h - by - rows : by;
+                for (int bx = tx; bx < tx + tile_w; bx += kBlockSize)
+                {
+                    const int cols = (tx + tile_w - bx < kBlockSize) ? tx + tile_w - bx : kBlockSize;
+                    const int out_row = mirror_y ? w - 1 - bx : bx;
+                    const Pixel *s = src + static_cast<ptrdiff_t>(first_row) * src_stride + bx;
+                    Pixel *d = dst + static_cast<ptrdiff_t>(out_row) * dst_stride + first_col;
+#if CONFIG_IDF_TARGET_ESP32S3
+                    if constexpr (sizeof(Pixel) == 2)
+                    {
+                        if (use_simd && rows == kBlockSize && cols == kBlockSize &&
+                            ((reinterpret_cast<uintptr_t>(s) | reinterpret_cast<uintptr_t>(d) |
+                              static_cast<uintptr_t>(src_stride * 2) | static_cast<uintptr_t>(dst_stride * 2)) &
+                             15) == 0)
+                        {
+                            rgb565_transpose_8x8_pie(s, static_cast<int>(src_step * 2), d, static_cast<int>(dst_step * 2));
+                            continue;
+                        }
+                    }
+#endif
+                    TransposeBlockScalar(s, src_step, d, dst_step, rows, cols);
+                }
+            }
+        }
+    }
+}
+
+void rgb565_rotate_swap_xy(const uint16_t *src, int w, int h, int src_stride,
+                           uint16_t *dst, int dst_stride, bool mirror_x, bool mirror_y)
+{
+    Rotate(src, w, h, src_stride, dst, dst_stride, mirror_x, mirror_y, true);
+}
+
+void rgb565_rotate_swap_xy_scalar(const uint16_t *src, int w, int h, int src_stride,
+                                  uint16_t *dst, int dst_stride, bool mirror_x, bool mirror_y)
+{
+    Rotate(src, w, h, src_stride, dst, dst_stride, mirror_x, mirror_y, false);
+}
+
+void l8_rotate_swap_xy(const uint8_t *src, int w, int h, int src_stride,
+                       uint8_t *dst, int dst_stride, bool mirror_x, bool mirror_y)
+{
+    Rotate(src, w, h, src_stride, dst, dst_stride, mirror_x, mirror_y, false);
+}
+
+void xrgb8888_rotate_swap_xy(const uint32_t *src, int w, int h, int src_stride,
+                             uint32_t *dst, int dst_stride, bool mirror_x, bool mirror_y)
+{
+    Rotate(src, w, h, src_stride, dst, dst_stride, mirror_x, mirror_y, false);
+}
@@ -0,0 +1,133 @@
+#include "rgb565_rotate.h"
+#include "bench_util.h"
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <cstring>
+
+#define TAG "RotateBench"
+
+struct BenchCase
+{
+    const char *name;
+    int width;
+    int height;
+    uint32_t src_caps; // where LVGL would have rendered the source
+};
+
+// Logical (landscape) sizes, rotated into a portrait 376x960 frame buffer in PSRAM
+static const BenchCase kBenchCases[] = {
+    {"full frame", 960, 376, MALLOC_CAP_SPIRAM},
+    {"render band", 960, 16, MALLOC_CAP_INTERNAL},
+    {"status label", 200, 32, MALLOC_CAP_INTERNAL},
+    {"unaligned area", 123, 37, MALLOC_CAP_INTERNAL},
+};
+
+static constexpr int kFrameWidth = 376;
+static constexpr int kFrameHeight = 960;
+
+typedef void (*RotateFn)(const uint16_t *, int, int, int, uint16_t *, int, bool, bool);
+
+// Straight per-pixel transcription of the mapping in rgb565_rotate.h, sharing no indexing with
+// the tiled kernels
+template <typename Pixel>
+static void NaiveRotate(const Pixel *src, int w, int h, Pixel *dst, int dst_stride, bool mirror_x, bool mirror_y)
+{
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            const int column = mirror_x ? h - 1 - y : y;
+            const int row = mirror_y ? w - 1 - x : x;
+            dst[row * dst_stride + column] = src[y * w + x];
+        }
+    }
+}
+
+// Every mirror combination of rotate against the naive loop, into a frame sized destination
+template <typename Pixel>
+static bool CheckRotate(const char *what, void (*rotate)(const Pixel *, int, int, int, Pixel *, int, bool, bool),
+                        const Pixel *src, int w, int h, Pixel *dst, Pixel *ref)
+{
+    const size_t frame_pixels = kFrameWidth * kFrameHeight;
+    for (int mode = 0; mode < 4; mode++)
+    {
+        const bool mirror_x = mode & 1;
+        const bool mirror_y = mode & 2;
+        memset(dst, 0, frame_pixels * sizeof(Pixel));
+        memset(ref, 0, frame_pixels * sizeof(Pixel));
+        rotate(src, w, h, w, dst, kFrameWidth, mirror_x, mirror_y);
+        NaiveRotate(src, w, h, ref, kFrameWidth, mirror_x, mirror_y);
+        if (!BenchMatches(TAG, what, dst, ref, frame_pixels))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static double MeasureMBps(RotateFn rotate, const BenchCase &c, const uint16_t *src, uint16_t *dst)
+{
+    const double us = BenchMeasureUs([&] { rotate(src, c.width, c.height, c.width, dst, kFrameWidth, true, false); });
+    return c.width * c.height * 2 / us; // bytes per microsecond == MB/s
+}
+
+int Rgb565RotateBenchmark()
+{
+    // Sized for the 32-bit variant, the others use the start of them
+    const size_t frame_bytes = kFrameWidth * kFrameHeight * 4;
+    auto dst = static_cast<uint16_t *>(heap_caps_aligned_alloc(16, frame_bytes, MALLOC_CAP_SPIRAM));
+    auto ref = static_cast<uint16_t *>(heap_caps_aligned_alloc(16, frame_bytes, MALLOC_CAP_SPIRAM));
+    if (dst == nullptr || ref == nullptr)
+    {
+        ESP_LOGE(TAG, "Failed to allocate frame buffers");
+        heap_caps_free(dst);
+        heap_caps_free(ref);
+        return 1;
+    }
+
+    int failures = 0;
+    for (const auto &c : kBenchCases)
+    {
+        const int pixels = c.width * c.height;
+        auto src = static_cast<uint16_t *>(heap_caps_aligned_alloc(16, pixels * 2, c.src_caps));
+        auto src8 = static_cast<uint8_t *>(heap_caps_malloc(pixels, MALLOC_CAP_SPIRAM));
+        auto src32 = static_cast<uint32_t *>(heap_caps_malloc(pixels * 4, MALLOC_CAP_SPIRAM));
+        if (src == nullptr || src8 == nullptr || src32 == nullptr)
+        {
+            ESP_LOGE(TAG, "%s: failed to allocate the sources", c.name);
+            heap_caps_free(src);
+            heap_caps_free(src8);
+            heap_caps_free(src32);
+            failures++;
+            continue;
+        }
+        for (int i = 0; i < pixels; i++)
+        {
+            const uint32_t p = i * 2654435761u;
+            src[i] = static_cast<uint16_t>(p >> 16);
+            src8[i] = static_cast<uint8_t>(p >> 24);
+            src32[i] = p;
+        }
+
+        // Both RGB565 paths and the 8 and 32-bit variants must match the naive loop before timing
+        bool match = CheckRotate(c.name, rgb565_rotate_swap_xy, src, c.width, c.height, dst, ref);
+        match = match && CheckRotate(c.name, rgb565_rotate_swap_xy_scalar, src, c.width, c.height, dst, ref);
+        match = match && CheckRotate(c.name, l8_rotate_swap_xy, src8, c.width, c.height,
+                                     reinterpret_cast<uint8_t *>(dst), reinterpret_cast<uint8_t *>(ref));
+        match = match && CheckRotate(c.name, xrgb8888_rotate_swap_xy, src32, c.width, c.height,
+                                     reinterpret_cast<uint32_t *>(dst), reinterpret_cast<uint32_t *>(ref));
+        failures += match ? 0 : 1;
+        heap_caps_free(src8);
+        heap_caps_free(src32);
+
+        double scalar = MeasureMBps(rgb565_rotate_swap_xy_scalar, c, src, dst);
+        double fast = MeasureMBps(rgb565_rotate_swap_xy, c, src, dst);
+        ESP_LOGI(TAG, "%-14s %4dx%-4d scalar %7.1f MB/s, dispatched %7.1f MB/s (x%.2f)",
+                 c.name, c.width, c.height, scalar, fast, fast / scalar);
+        heap_caps_free(src);
+    }
+
+    heap_caps_free(dst);
+    heap_caps_free(ref);
+    return failures;
+}
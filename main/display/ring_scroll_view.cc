@@ -0,0 +1,106 @@
+#include "ring_scroll_view.h"
+#include "lcd_display.h"
+#include <lvgl_private.h>
+#include <esp_log.h>
+#include <algorithm>
+#include <cstdlib>
+
+#define TAG "RingScrollView"
+
+RingScrollView::RingScrollView(RgbLcdDisplay *display, lv_obj_t *screen, int y, int height)
+    : display_(display), height_(height)
+{
+    // No border, radius or shadow: anything that belongs to the band's edges would scroll with it
+    container_ = lv_obj_create(screen);
+    lv_obj_remove_style_all(container_);
+    lv_obj_set_pos(container_, 0, y);
+    lv_obj_set_size(container_, lv_pct(100), height);
+    lv_obj_set_style_bg_color(container_, lv_obj_get_style_bg_color(screen, LV_PART_MAIN), 0);
+    lv_obj_set_style_bg_opa(container_, LV_OPA_COVER, 0);
+    lv_obj_set_scrollbar_mode(container_, LV_SCROLLBAR_MODE_OFF);
+
+    ring_ = display_->SetRingView(y, height);
+    if (ring_)
+    {
+        // Scrolled from here only, a drag would take LVGL's path
+        lv_obj_remove_flag(container_, LV_OBJ_FLAG_SCROLLABLE);
+    }
+    else
+    {
+        ESP_LOGW(TAG, "No scan-out ring, scrolling rows %d..%d with LVGL", y, y + height);
+    }
+}
+
+RingScrollView::~RingScrollView()
+{
+    lv_anim_delete(this, nullptr);
+    if (ring_)
+    {
+        display_->SetRingView(0, 0);
+    }
+    lv_obj_delete(container_);
+}
+
+void RingScrollView::ScrollTo(int y, bool anim)
+{
+    lv_anim_delete(this, nullptr);
+    lv_obj_update_layout(container_);
+    y = std::clamp(y, 0, scroll_y_ + static_cast<int>(lv_obj_get_scroll_bottom(container_)));
+    const int distance = std::abs(y - scroll_y_);
+    if (!anim || distance == 0)
+    {
+        ScrollRaw(y);
+        return;
+    }
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, this);
+    lv_anim_set_values(&a, scroll_y_, y);
+    lv_anim_set_duration(&a, std::clamp(distance * 1000 / kAnimSpeed, kAnimMinTime, kAnimMaxTime));
+    lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
+    lv_anim_set_exec_cb(&a, [](void *var, int32_t v)
+    {
+        static_cast<RingScrollView *>(var)->ScrollRaw(v);
+    });
+    lv_anim_start(&a);
+}
+
+void RingScrollView::ScrollRaw(int y)
+{
+    const int dy = y - scroll_y_;
+    if (dy == 0)
+    {
+        return;
+    }
+    scroll_y_ = y;
+    if (!ring_)
+    {
+        lv_obj_scroll_to_y(container_, y, LV_ANIM_OFF);
+        return;
+    }
+
+    // What lv_obj_scroll_by does, minus invalidating the whole container
+    lv_obj_allocate_spec_attr(container_);
+    container_->spec_attr->scroll.y -= dy;
+    lv_obj_move_children_by(container_, 0, -dy, true);
+    display_->ScrollRing(dy);
+    lv_obj_send_event(container_, LV_EVENT_SCROLL, nullptr);
+
+    if (std::abs(dy) >= height_)
+    {
+        lv_obj_invalidate(container_);
+        return;
+    }
+    // Only the strip that came into view
+    lv_area_t exposed = container_->coords;
+    if (dy > 0)
+    {
+        exposed.y1 = exposed.y2 - dy + 1;
+    }
+    else
+    {
+        exposed.y2 = exposed.y1 - dy - 1;
+    }
+    lv_obj_invalidate_area(container_, &exposed);
+}
@@ -0,0 +1,44 @@
+#ifndef RING_SCROLL_VIEW_H
+#define RING_SCROLL_VIEW_H
+
+#include <lvgl.h>
+
+class RgbLcdDisplay;
+
+// A full-width container for lists and logs that scrolls through the scan-out ring
+// (RgbLcdDisplay::SetRingView): a scroll step moves the offset the band is scanned out with and
+// only draws the rows it exposes, where an LVGL scroll redraws the whole visible area. Rows
+// already on screen move without being redrawn, so the container has a plain background and
+// nothing else may be drawn over its band; children go into container(). Without the ring it
+// falls back to plain LVGL scrolling.
+//
+// Create, scroll and delete it under the LVGL lock.
+class RingScrollView
+{
+public:
+    // Rows [y, y + height) of the screen, across its whole width
+    RingScrollView(RgbLcdDisplay *display, lv_obj_t *screen, int y, int height);
+    ~RingScrollView();
+
+    lv_obj_t *container() const { return container_; }
+    int scroll_y() const { return scroll_y_; }
+    // Clamped to the content, anim eases there over a few frames
+    void ScrollTo(int y, bool anim);
+    void ScrollBy(int dy, bool anim) { ScrollTo(scroll_y_ + dy, anim); }
+
+private:
+    // Pixels per second of an animated scroll, and its bounds in ms
+    static constexpr int kAnimSpeed = 1500;
+    static constexpr int kAnimMinTime = 100;
+    static constexpr int kAnimMaxTime = 400;
+
+    RgbLcdDisplay *display_;
+    lv_obj_t *container_ = nullptr;
+    int height_;
+    bool ring_ = false;
+    int scroll_y_ = 0;
+
+    void ScrollRaw(int y);
+};
+
+#endif // RING_SCROLL_VIEW_H
@@ -0,0 +1,199 @@
+#include "stream_font.h"
+#include <esp_log.h>
+#include <cstring>
+
+#define TAG "StreamFont"
+
+// Partition layout, little endian:
+//   FontPackHeader, glyph_count x GlyphRecord sorted by code point, then the bitmaps.
+//   A bitmap is box_h rows of box_w pixels at bpp bits each, most significant bits first,
+//   every row starting on a byte boundary.
+struct FontPackHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t bpp;
+    uint8_t reserved;
+    int16_t line_height;
+    int16_t base_line;
+    int8_t underline_position;
+    uint8_t underline_thickness;
+    uint16_t reserved2;
+    uint32_t glyph_count;
+    uint32_t bitmap_offset; // from the start of the partition
+    uint32_t total_size;
+};
+static_assert(sizeof(FontPackHeader) == 28, "font pack header is 28 bytes");
+
+static constexpr uint32_t kFontMagic = 0x31544E46; // "FNT1"
+static constexpr uint16_t kFontVersion = 1;
+
+StreamFont::~StreamFont()
+{
+    if (mapped_ != nullptr)
+    {
+        esp_partition_munmap(mmap_handle_);
+    }
+}
+
+bool StreamFont::Load(const lv_font_t *fallback)
+{
+    if (loaded_)
+    {
+        return mapped_ != nullptr;
+    }
+    loaded_ = true;
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                                STREAM_FONT_PARTITION);
+    if (partition == nullptr)
+    {
+        ESP_LOGW(TAG, "No '%s' partition", STREAM_FONT_PARTITION);
+        return false;
+    }
+
+    FontPackHeader header;
+    if (esp_partition_read(partition, 0, &header, sizeof(header)) != ESP_OK || header.magic != kFontMagic ||
+        header.version != kFontVersion || header.total_size > partition->size ||
+        (header.bpp != 1 && header.bpp != 2 && header.bpp != 4 && header.bpp != 8) ||
+        header.bitmap_offset < sizeof(header) + header.glyph_count * sizeof(GlyphRecord) ||
+        header.bitmap_offset > header.total_size)
+    {
+        ESP_LOGW(TAG, "No font in '%s'", STREAM_FONT_PARTITION);
+        return false;
+    }
+
+    // Only the used part is mapped, the rest of the partition costs no MMU pages
+    const void *mapped = nullptr;
+    if (esp_partition_mmap(partition, 0, header.total_size, ESP_PARTITION_MMAP_DATA, &mapped, &mmap_handle_) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Failed to map '%s'", STREAM_FONT_PARTITION);
+        return false;
+    }
+    mapped_ = static_cast<const uint8_t *>(mapped);
+    glyphs_ = reinterpret_cast<const GlyphRecord *>(mapped_ + sizeof(header));
+    glyph_count_ = header.glyph_count;
+    bitmaps_ = mapped_ + header.bitmap_offset;
+    bitmap_size_ = header.total_size - header.bitmap_offset;
+    bpp_ = header.bpp;
+    for (auto &entry : index_cache_)
+    {
+        entry.codepoint = kNoGlyph;
+    }
+    stats_.glyphs = glyph_count_;
+
+    font_.get_glyph_dsc = GetGlyphDsc;
+    font_.get_glyph_bitmap = GetGlyphBitmap;
+    font_.line_height = header.line_height;
+    font_.base_line = header.base_line;
+    font_.underline_position = header.underline_position;
+    font_.underline_thickness = header.underline_thickness;
+    font_.dsc = this;
+    font_.fallback = fallback;
+
+    ESP_LOGI(TAG, "%lu glyphs, %d px line, %u bpp in '%s' (%lu bytes)", (unsigned long)glyph_count_,
+             header.line_height, bpp_, STREAM_FONT_PARTITION, (unsigned long)header.total_size);
+    return true;
+}
+
+uint32_t StreamFont::FindGlyph(uint32_t codepoint)
+{
+    IndexCacheEntry &cached = index_cache_[codepoint & (kIndexCacheSize - 1)];
+    if (cached.codepoint == codepoint)
+    {
+        stats_.index_hits++;
+        return cached.glyph;
+    }
+    stats_.index_misses++;
+
+    // The table is read through the flash cache, a lookup touches about log2(count) records
+    uint32_t low = 0;
+    uint32_t high = glyph_count_;
+    uint32_t glyph = kNoGlyph;
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        uint32_t value = glyphs_[mid].codepoint;
+        if (value == codepoint)
+        {
+            glyph = mid;
+            break;
+        }
+        if (value < codepoint)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    cached.codepoint = codepoint;
+    cached.glyph = glyph;
+    return glyph;
+}
+
+bool StreamFont::GetGlyphDsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc, uint32_t letter, uint32_t)
+{
+    auto *self = static_cast<StreamFont *>(const_cast<void *>(font->dsc));
+    self->stats_.lookups++;
+    uint32_t glyph = self->FindGlyph(letter);
+    if (glyph == kNoGlyph)
+    {
+        return false;
+    }
+
+    const GlyphRecord &record = self->glyphs_[glyph];
+    dsc->adv_w = record.adv_w;
+    dsc->box_w = record.box_w;
+    dsc->box_h = record.box_h;
+    dsc->ofs_x = record.ofs_x;
+    dsc->ofs_y = record.ofs_y;
+    dsc->format = static_cast<lv_font_glyph_format_t>(self->bpp_); // A1..A8 share their bpp value
+    dsc->is_placeholder = 0;
+    dsc->gid.index = glyph;
+    return true;
+}
+
+const void *StreamFont::GetGlyphBitmap(lv_font_glyph_dsc_t *dsc, lv_draw_buf_t *draw_buf)
+{
+    auto *self = static_cast<StreamFont *>(const_cast<void *>(dsc->resolved_font->dsc));
+    const GlyphRecord &record = self->glyphs_[dsc->gid.index];
+    const uint32_t bpp = self->bpp_;
+    const uint32_t row_bytes = (record.box_w * bpp + 7) / 8;
+    const uint32_t stride = draw_buf->header.stride;
+    if (record.offset + row_bytes * record.box_h > self->bitmap_size_ || stride * record.box_h > draw_buf->data_size)
+    {
+        return nullptr;
+    }
+    self->stats_.bitmaps++;
+
+    // Expand to A8, scaling each value so the largest one becomes 255
+    const uint32_t mask = (1u << bpp) - 1;
+    const uint32_t scale = 255 / mask;
+    const uint8_t *src = self->bitmaps_ + record.offset;
+    uint8_t *dst = draw_buf->data;
+    for (int y = 0; y < record.box_h; y++)
+    {
+        if (bpp == 8)
+        {
+            memcpy(dst, src, record.box_w);
+        }
+        else
+        {
+            for (int x = 0; x < record.box_w; x++)
+            {
+                uint32_t bit = x * bpp;
+                dst[x] = ((src[bit >> 3] >> (8 - bpp - (bit & 7))) & mask) * scale;
+            }
+        }
+        src += row_bytes;
+        dst += stride;
+    }
+    return draw_buf;
+}
+
+StreamFontStats StreamFont::GetStats() const
+{
+    return stats_;
+}
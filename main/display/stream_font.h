@@ -0,0 +1,85 @@
+#ifndef STREAM_FONT_H
+#define STREAM_FONT_H
+
+#include <lvgl.h>
+#include <esp_partition.h>
+#include <cstdint>
+
+// Partition holding the CJK font, written by tools/build_font.py
+#define STREAM_FONT_PARTITION "font"
+
+struct StreamFontStats
+{
+    uint32_t glyphs = 0;       // glyphs in the partition
+    uint32_t lookups = 0;      // get_glyph_dsc calls
+    uint32_t index_hits = 0;   // answered from the RAM index cache
+    uint32_t index_misses = 0; // binary searched in the mapped glyph table
+    uint32_t bitmaps = 0;      // glyph bitmaps expanded from flash
+};
+
+// A bitmap font read on demand from a memory mapped partition instead of being compiled into the
+// app. Glyph records are binary searched in the mapped table and the recent ones are kept in a
+// small direct-mapped cache in RAM; bitmaps are expanded from flash into LVGL's glyph buffer.
+// Wrap the font with GlyphCache to avoid expanding the same glyphs on every frame.
+// Used from the LVGL task only.
+class StreamFont
+{
+public:
+    static StreamFont &GetInstance()
+    {
+        static StreamFont instance;
+        return instance;
+    }
+
+    // Maps the partition, characters missing from it are drawn with fallback. Safe to call more than once.
+    bool Load(const lv_font_t *fallback = nullptr);
+    // nullptr until Load succeeded
+    const lv_font_t *font() const { return mapped_ != nullptr ? &font_ : nullptr; }
+    StreamFontStats GetStats() const;
+
+private:
+    static constexpr int kIndexCacheSize = 256; // power of two
+    static constexpr uint32_t kNoGlyph = UINT32_MAX;
+
+    struct GlyphRecord
+    {
+        uint32_t codepoint;
+        uint32_t offset; // from the start of the bitmap area
+        uint16_t adv_w;
+        uint8_t box_w;
+        uint8_t box_h;
+        int8_t ofs_x;
+        int8_t ofs_y;
+        uint16_t reserved;
+    };
+    static_assert(sizeof(GlyphRecord) == 16, "glyph record is 16 bytes");
+
+    struct IndexCacheEntry
+    {
+        uint32_t codepoint; // kNoGlyph for an empty slot
+        uint32_t glyph;     // kNoGlyph if the partition does not have the character
+    };
+
+    StreamFont() = default;
+    ~StreamFont();
+    StreamFont(const StreamFont &) = delete;
+    StreamFont &operator=(const StreamFont &) = delete;
+
+    bool loaded_ = false;
+    const uint8_t *mapped_ = nullptr;
+    esp_partition_mmap_handle_t mmap_handle_ = 0;
+    const GlyphRecord *glyphs_ = nullptr;
+    uint32_t glyph_count_ = 0;
+    const uint8_t *bitmaps_ = nullptr;
+    uint32_t bitmap_size_ = 0;
+    uint8_t bpp_ = 0;
+    lv_font_t font_ = {};
+    IndexCacheEntry index_cache_[kIndexCacheSize];
+    StreamFontStats stats_;
+
+    uint32_t FindGlyph(uint32_t codepoint);
+    static bool GetGlyphDsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc, uint32_t letter, uint32_t letter_next);
+    static const void *GetGlyphBitmap(lv_font_glyph_dsc_t *dsc, lv_draw_buf_t *draw_buf);
+};
+
+#endif // STREAM_FONT_H
@@ -0,0 +1,153 @@
+#include "ui_command_queue.h"
+#include <algorithm>
+#include <cstring>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define TAG "UiCommandQueue"
+
+// Copy text and cut it before a partial UTF-8 sequence if it does not fit
+static void CopyText(char *dst, const char *src)
+{
+    if (src == nullptr)
+    {
+        dst[0] = '\0';
+        return;
+    }
+    size_t len = strnlen(src, kUiCommandTextSize);
+    if (len == kUiCommandTextSize)
+    {
+        len = kUiCommandTextSize - 1;
+        while (len > 0 && (static_cast<uint8_t>(src[len]) & 0xC0) == 0x80)
+        {
+            len--;
+        }
+    }
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+UiCommandQueue::UiCommandQueue(UiOverflowPolicy policy, int wait_timeout_ms)
+    : policy_(policy), wait_timeout_ms_(wait_timeout_ms)
+{
+    for (uint32_t i = 0; i < kCapacity; i++)
+    {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool UiCommandQueue::TryPost(UiCommandType type, const char *text, int duration_ms, uint32_t generation)
+{
+    uint32_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;)
+    {
+        slot = &slots_[pos & (kCapacity - 1)];
+        uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int32_t diff = static_cast<int32_t>(sequence - pos);
+        if (diff == 0)
+        {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The consumer has not released this slot yet, the ring is full
+            return false;
+        }
+        else
+        {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->command.type = type;
+    slot->command.duration_ms = duration_ms;
+    slot->command.generation = generation;
+    slot->command.post_us = esp_timer_get_time();
+    CopyText(slot->command.text, text);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool UiCommandQueue::Post(UiCommandType type, const char *text, int duration_ms, uint32_t generation)
+{
+    bool posted = TryPost(type, text, duration_ms, generation);
+    if (!posted && policy_ == UiOverflowPolicy::kWaitForSpace)
+    {
+        TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(wait_timeout_ms_);
+        while (!posted && static_cast<int32_t>(deadline - xTaskGetTickCount()) > 0)
+        {
+            vTaskDelay(1);
+            posted = TryPost(type, text, duration_ms, generation);
+        }
+    }
+
+    if (!posted)
+    {
+        uint32_t dropped = dropped_.fetch_add(1, std::memory_order_relaxed) + 1;
+        // Only log the first drop of every burst, the counter keeps the rest
+        if ((dropped & (dropped - 1)) == 0)
+        {
+            ESP_LOGW(TAG, "UI queue full, dropped %lu commands so far", (unsigned long)dropped);
+        }
+        return false;
+    }
+    posted_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool UiCommandQueue::Pop(UiCommand &command)
+{
+    Slot &slot = slots_[dequeue_pos_ & (kCapacity - 1)];
+    uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<int32_t>(sequence - (dequeue_pos_ + 1)) < 0)
+    {
+        return false;
+    }
+
+    uint32_t depth = enqueue_pos_.load(std::memory_order_relaxed) - dequeue_pos_;
+    high_water_ = std::max(high_water_, depth);
+
+    command = slot.command;
+    slot.sequence.store(dequeue_pos_ + kCapacity, std::memory_order_release);
+    dequeue_pos_++;
+    drained_++;
+    return true;
+}
+
+void UiCommandQueue::RecordLatency(const UiCommand &command, int64_t now_us)
+{
+    uint32_t latency_us = now_us - command.post_us;
+    latency_sum_us_ += latency_us;
+    max_latency_us_ = std::max(max_latency_us_, latency_us);
+}
+
+void UiCommandQueue::RecordPresented(int64_t post_us, int64_t now_us)
+{
+    uint32_t latency_us = now_us - post_us;
+    presented_++;
+    photon_sum_us_ += latency_us;
+    max_photon_us_ = std::max(max_photon_us_, latency_us);
+}
+
+UiQueueStats UiCommandQueue::GetStats() const
+{
+    // Consumer side fields are read without synchronisation, good enough for a log line
+    UiQueueStats stats;
+    stats.posted = posted_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.drained = drained_;
+    stats.coalesced = coalesced_;
+    stats.high_water = high_water_;
+    stats.avg_latency_us = drained_ ? latency_sum_us_ / drained_ : 0;
+    stats.max_latency_us = max_latency_us_;
+    stats.presented = presented_;
+    stats.avg_photon_us = presented_ ? photon_sum_us_ / presented_ : 0;
+    stats.max_photon_us = max_photon_us_;
+    return stats;
+}
@@ -0,0 +1,97 @@
+#ifndef UI_COMMAND_QUEUE_H
+#define UI_COMMAND_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Room for a status or notification text, longer texts are cut at a UTF-8 character boundary
+static constexpr size_t kUiCommandTextSize = 96;
+
+enum class UiCommandType : uint8_t
+{
+    kSetStatus,
+    kShowNotification,
+    kHideNotification,
+};
+
+struct UiCommand
+{
+    UiCommandType type;
+    int duration_ms;     // kShowNotification only
+    uint32_t generation; // notification the command belongs to, see Display::ShowNotification
+    int64_t post_us;
+    char text[kUiCommandTextSize];
+};
+
+// What Post does when every slot is taken
+enum class UiOverflowPolicy
+{
+    kDropNewest,   // reject the new command straight away
+    kWaitForSpace, // retry once per tick until a slot frees up or the timeout expires, then drop
+};
+
+struct UiQueueStats
+{
+    uint32_t posted = 0;    // commands accepted into the ring
+    uint32_t dropped = 0;   // commands rejected because the ring was full
+    uint32_t drained = 0;   // commands taken out by the LVGL task
+    uint32_t coalesced = 0; // drained commands that were superseded by a later one in the same frame
+    uint32_t high_water = 0;
+    uint32_t avg_latency_us = 0; // post to drain
+    uint32_t max_latency_us = 0;
+    uint32_t presented = 0;        // frames that showed the result of at least one command
+    uint32_t avg_photon_us = 0;    // post of the oldest command in the frame to the frame on screen
+    uint32_t max_photon_us = 0;
+};
+
+// Bounded multi-producer/single-consumer ring of UI commands. Any task may post without taking the
+// LVGL lock, the LVGL task drains it once per frame. Slots carry a sequence number, producers claim
+// a slot with one compare-and-swap on the enqueue position and publish it by bumping the sequence.
+class UiCommandQueue
+{
+public:
+    static constexpr uint32_t kCapacity = 32;
+
+    explicit UiCommandQueue(UiOverflowPolicy policy = UiOverflowPolicy::kDropNewest, int wait_timeout_ms = 50);
+
+    bool Post(UiCommandType type, const char *text = nullptr, int duration_ms = 0, uint32_t generation = 0);
+
+    // Consumer side, only ever called from the LVGL task
+    bool Pop(UiCommand &command);
+    void RecordLatency(const UiCommand &command, int64_t now_us);
+    void RecordCoalesced(uint32_t count) { coalesced_ += count; }
+    void RecordPresented(int64_t post_us, int64_t now_us);
+
+    UiQueueStats GetStats() const;
+
+private:
+    static_assert((kCapacity & (kCapacity - 1)) == 0, "capacity must be a power of two");
+
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence;
+        UiCommand command;
+    };
+
+    bool TryPost(UiCommandType type, const char *text, int duration_ms, uint32_t generation);
+
+    UiOverflowPolicy policy_;
+    int wait_timeout_ms_;
+    Slot slots_[kCapacity];
+    std::atomic<uint32_t> enqueue_pos_{0};
+    uint32_t dequeue_pos_ = 0;
+
+    std::atomic<uint32_t> posted_{0};
+    std::atomic<uint32_t> dropped_{0};
+    uint32_t drained_ = 0;
+    uint32_t coalesced_ = 0;
+    uint32_t high_water_ = 0;
+    uint64_t latency_sum_us_ = 0;
+    uint32_t max_latency_us_ = 0;
+    uint32_t presented_ = 0;
+    uint64_t photon_sum_us_ = 0;
+    uint32_t max_photon_us_ = 0;
+};
+
+#endif // UI_COMMAND_QUEUE_H
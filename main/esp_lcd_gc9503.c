@@ -13,8 +13,10 @@
 #include <esp_lcd_panel_io.h>
 #include <esp_lcd_panel_vendor.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 
 #include "esp_lcd_gc9503.h"
+#include "esp_lcd_gc9503_init.h"
 
 #define GC9503_CMD_MADCTL (0xB1)         // Memory data access control
 #define GC9503_CMD_MADCTL_DEFAULT (0x10) // Default value of Memory data access control
@@ -246,49 +248,31 @@ err:
 //     {0x11, (uint8_t []){0x00}, 0, 120},
 //     {0x29, (uint8_t []){0x00}, 0, 20},
 // };
-static const gc9503_lcd_init_cmd_t vendor_specific_init_default[] = {
-    // {0x11, (uint8_t[]){}, 0, 20},
-
-    {0xF0, (uint8_t[]){0x55, 0xAA, 0x52, 0x08, 0x00}, 5, 0},
-    {0xF6, (uint8_t[]){0x5A, 0x87}, 2, 0},
-    {0xC1, (uint8_t[]){0x3F}, 1, 0},
-    {0xCD, (uint8_t[]){0x25}, 1, 0},
-    {0xC9, (uint8_t[]){0x10}, 1, 0},
-    {0xF8, (uint8_t[]){0x8A}, 1, 0},
-    {0xAC, (uint8_t[]){0x45}, 1, 0},
-    {0xA7, (uint8_t[]){0x47}, 1, 0},
-    {0xA0, (uint8_t[]){0x88}, 1, 0},
-    {0x86, (uint8_t[]){0x99, 0xA3, 0xA3, 0x51}, 4, 0},
-    {0xFA, (uint8_t[]){0x08, 0x08, 0x00, 0x04}, 4, 0},
-    {0xA3, (uint8_t[]){0x6E}, 1, 0},
-    {0xFD, (uint8_t[]){0x28, 0x3C, 0x00}, 3, 0},
-    {0x9A, (uint8_t[]){0x4B}, 1, 0},
-    {0x9B, (uint8_t[]){0x4B}, 1, 0},
-    {0x82, (uint8_t[]){0x20, 0x20}, 2, 0},
-    {0xB1, (uint8_t[]){0x10}, 1, 0},
-    {0x7A, (uint8_t[]){0x0F, 0x13}, 2, 0},
-    {0x7B, (uint8_t[]){0x0F, 0x13}, 2, 0},
-    {0x6D, (uint8_t[]){0x1e, 0x1e, 0x04, 0x02, 0x0d, 0x1e, 0x12, 0x11, 0x14, 0x13, 0x05, 0x06, 0x1d, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1d, 0x06, 0x05, 0x0b, 0x0c, 0x09, 0x0a, 0x1e, 0x0d, 0x01, 0x03, 0x1e, 0x1e}, 32, 0},
-    {0x64, (uint8_t[]){0x38, 0x08, 0x03, 0xc0, 0x03, 0x03, 0x38, 0x06, 0x03, 0xc2, 0x03, 0x03, 0x20, 0x6d, 0x20, 0x6d}, 16, 0},
-    {0x65, (uint8_t[]){0x38, 0x04, 0x03, 0xc4, 0x03, 0x03, 0x38, 0x02, 0x03, 0xc6, 0x03, 0x03, 0x20, 0x6d, 0x20, 0x6d}, 16, 0},
-    {0x66, (uint8_t[]){0x83, 0xcf, 0x03, 0xc8, 0x03, 0x03, 0x83, 0xd3, 0x03, 0xd2, 0x03, 0x03, 0x20, 0x6d, 0x20, 0x6d}, 16, 0},
-    {0x60, (uint8_t[]){0x38, 0x0C, 0x20, 0x6D, 0x38, 0x0B, 0x20, 0x6D}, 8, 0},
-    {0x61, (uint8_t[]){0x38, 0x0A, 0x20, 0x6D, 0x38, 0x09, 0x20, 0x6D}, 8, 0},
-    {0x62, (uint8_t[]){0x38, 0x25, 0x20, 0x6D, 0x63, 0xC9, 0x20, 0x6D}, 8, 0},
-    {0x69, (uint8_t[]){0x14, 0x22, 0x14, 0x22, 0x14, 0x22, 0x08}, 7, 0},
-    {0x6B, (uint8_t[]){0x07}, 1, 0},
-    {0xD1, (uint8_t[]){0x00, 0x00, 0x00, 0x70, 0x00, 0x8f, 0x00, 0xab, 0x00, 0xbf, 0x00, 0xdf, 0x00, 0xfa, 0x01, 0x2a, 0x01, 0x52, 0x01, 0x90, 0x01, 0xc1, 0x02, 0x0e, 0x02, 0x4f, 0x02, 0x51, 0x02, 0x8d, 0x02, 0xd3, 0x02, 0xff, 0x03, 0x3c, 0x03, 0x64, 0x03, 0xa1, 0x03, 0xf1, 0x03, 0xff, 0x03, 0xfF, 0x03, 0xff, 0x03, 0xFf, 0x03, 0xFF}, 52, 0},
-    {0xD2, (uint8_t[]){0x00, 0x00, 0x00, 0x70, 0x00, 0x8f, 0x00, 0xab, 0x00, 0xbf, 0x00, 0xdf, 0x00, 0xfa, 0x01, 0x2a, 0x01, 0x52, 0x01, 0x90, 0x01, 0xc1, 0x02, 0x0e, 0x02, 0x4f, 0x02, 0x51, 0x02, 0x8d, 0x02, 0xd3, 0x02, 0xff, 0x03, 0x3c, 0x03, 0x64, 0x03, 0xa1, 0x03, 0xf1, 0x03, 0xff, 0x03, 0xfF, 0x03, 0xff, 0x03, 0xFf, 0x03, 0xFF}, 52, 0},
-    {0xD3, (uint8_t[]){0x00, 0x00, 0x00, 0x70, 0x00, 0x8f, 0x00, 0xab, 0x00, 0xbf, 0x00, 0xdf, 0x00, 0xfa, 0x01, 0x2a, 0x01, 0x52, 0x01, 0x90, 0x01, 0xc1, 0x02, 0x0e, 0x02, 0x4f, 0x02, 0x51, 0x02, 0x8d, 0x02, 0xd3, 0x02, 0xff, 0x03, 0x3c, 0x03, 0x64, 0x03, 0xa1, 0x03, 0xf1, 0x03, 0xff, 0x03, 0xfF, 0x03, 0xff, 0x03, 0xFf, 0x03, 0xFF}, 52, 0},
-    {0xD4, (uint8_t[]){0x00, 0x00, 0x00, 0x70, 0x00, 0x8f, 0x00, 0xab, 0x00, 0xbf, 0x00, 0xdf, 0x00, 0xfa, 0x01, 0x2a, 0x01, 0x52, 0x01, 0x90, 0x01, 0xc1, 0x02, 0x0e, 0x02, 0x4f, 0x02, 0x51, 0x02, 0x8d, 0x02, 0xd3, 0x02, 0xff, 0x03, 0x3c, 0x03, 0x64, 0x03, 0xa1, 0x03, 0xf1, 0x03, 0xff, 0x03, 0xfF, 0x03, 0xff, 0x03, 0xFf, 0x03, 0xFF}, 52, 0},
-    {0xD5, (uint8_t[]){0x00, 0x00, 0x00, 0x70, 0x00, 0x8f, 0x00, 0xab, 0x00, 0xbf, 0x00, 0xdf, 0x00, 0xfa, 0x01, 0x2a, 0x01, 0x52, 0x01, 0x90, 0x01, 0xc1, 0x02, 0x0e, 0x02, 0x4f, 0x02, 0x51, 0x02, 0x8d, 0x02, 0xd3, 0x02, 0xff, 0x03, 0x3c, 0x03, 0x64, 0x03, 0xa1, 0x03, 0xf1, 0x03, 0xff, 0x03, 0xfF, 0x03, 0xff, 0x03, 0xFf, 0x03, 0xFF}, 52, 0},
-    {0xD6, (uint8_t[]){0x00, 0x00, 0x00, 0x70, 0x00, 0x8f, 0x00, 0xab, 0x00, 0xbf, 0x00, 0xdf, 0x00, 0xfa, 0x01, 0x2a, 0x01, 0x52, 0x01, 0x90, 0x01, 0xc1, 0x02, 0x0e, 0x02, 0x4f, 0x02, 0x51, 0x02, 0x8d, 0x02, 0xd3, 0x02, 0xff, 0x03, 0x3c, 0x03, 0x64, 0x03, 0xa1, 0x03, 0xf1, 0x03, 0xff, 0x03, 0xfF, 0x03, 0xff, 0x03, 0xFf, 0x03, 0xFF}, 52, 0},
-    // {0x3A, (uint8_t[]){0x55}, 1, 0},
-
-    {0x11, NULL, 0, 120}, // Delay 120ms
-    {0x29, NULL, 0, 120}};
+// The default sequence is packed at compile time, see esp_lcd_gc9503_init.cc
 
-// *INDENT-OFF*
+// Check if the command has been used or conflicts with the internal
+static void panel_gc9503_check_cmd(gc9503_panel_t *gc9503, int cmd, const void *data)
+{
+    bool is_cmd_overwritten = false;
+    switch (cmd)
+    {
+    case LCD_CMD_MADCTL:
+        is_cmd_overwritten = true;
+        gc9503->madctl_val = ((const uint8_t *)data)[0];
+        break;
+    case LCD_CMD_COLMOD:
+        is_cmd_overwritten = true;
+        gc9503->colmod_val = ((const uint8_t *)data)[0];
+        break;
+    default:
+        break;
+    }
+
+    if (is_cmd_overwritten)
+    {
+        ESP_LOGW(TAG, "The %02Xh command has been used and will be overwritten by external initialization sequence", cmd);
+    }
+}
 
 static esp_err_t panel_gc9503_send_init_cmds(gc9503_panel_t *gc9503)
 {
@@ -309,48 +293,61 @@ static esp_err_t panel_gc9503_send_init_cmds(gc9503_panel_t *gc9503)
 
     // Vendor specific initialization, it can be different between manufacturers
     // should consult the LCD supplier for initialization sequence code
-    const gc9503_lcd_init_cmd_t *init_cmds = NULL;
-    uint16_t init_cmds_size = 0;
+    int64_t start_us = esp_timer_get_time();
+    uint32_t delay_ms_total = 0;
+    size_t cmd_count = 0;
+    size_t data_bytes_total = 0;
     if (gc9503->init_cmds)
     {
-        init_cmds = gc9503->init_cmds;
-        init_cmds_size = gc9503->init_cmds_size;
+        const gc9503_lcd_init_cmd_t *init_cmds = gc9503->init_cmds;
+        uint16_t init_cmds_size = gc9503->init_cmds_size;
+        for (int i = 0; i < init_cmds_size; i++)
+        {
+            panel_gc9503_check_cmd(gc9503, init_cmds[i].cmd, init_cmds[i].data);
+            ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, init_cmds[i].cmd, init_cmds[i].data, init_cmds[i].data_bytes),
+                                TAG, "send command failed");
+            if (init_cmds[i].delay_ms)
+            {
+                vTaskDelay(pdMS_TO_TICKS(init_cmds[i].delay_ms));
+                delay_ms_total += init_cmds[i].delay_ms;
+            }
+            data_bytes_total += init_cmds[i].data_bytes;
+        }
+        cmd_count = init_cmds_size;
     }
     else
     {
-        init_cmds = vendor_specific_init_default;
-        init_cmds_size = sizeof(vendor_specific_init_default) / sizeof(gc9503_lcd_init_cmd_t);
-    }
-
-    bool is_cmd_overwritten = false;
-    for (int i = 0; i < init_cmds_size; i++)
-    {
-        // Check if the command has been used or conflicts with the internal
-        switch (init_cmds[i].cmd)
-        {
-        case LCD_CMD_MADCTL:
-            is_cmd_overwritten = true;
-            gc9503->madctl_val = ((uint8_t *)init_cmds[i].data)[0];
-            break;
-        case LCD_CMD_COLMOD:
-            is_cmd_overwritten = true;
-            gc9503->colmod_val = ((uint8_t *)init_cmds[i].data)[0];
-            break;
-        default:
-            is_cmd_overwritten = false;
-            break;
-        }
-
-        if (is_cmd_overwritten)
+        const uint8_t *blob = gc9503_default_init_blob;
+        const uint8_t *blob_end = blob + gc9503_default_init_blob_size;
+        const uint8_t *data = NULL;
+        while (blob < blob_end)
         {
-            ESP_LOGW(TAG, "The %02Xh command has been used and will be overwritten by external initialization sequence",
-                     init_cmds[i].cmd);
+            uint8_t cmd = blob[0];
+            uint8_t flags = blob[1];
+            size_t data_bytes = flags & GC9503_INIT_BLOB_SIZE_MASK;
+            blob += 2;
+            if (!(flags & GC9503_INIT_BLOB_REPEAT))
+            {
+                data = blob;
+                blob += data_bytes;
+            }
+            panel_gc9503_check_cmd(gc9503, cmd, data);
+            ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, cmd, data_bytes ? data : NULL, data_bytes),
+                                TAG, "send command failed");
+            if (flags & GC9503_INIT_BLOB_DELAY)
+            {
+                vTaskDelay(pdMS_TO_TICKS(*blob));
+                delay_ms_total += *blob;
+                blob++;
+            }
+            data_bytes_total += data_bytes;
+            cmd_count++;
         }
-
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, init_cmds[i].cmd, init_cmds[i].data, init_cmds[i].data_bytes),
-                            TAG, "send command failed");
-        vTaskDelay(pdMS_TO_TICKS(init_cmds[i].delay_ms));
     }
+    ESP_LOGI(TAG, "Init sequence: %u commands, %u data bytes%s in %lld us (%lu ms waiting)",
+             (unsigned)cmd_count, (unsigned)data_bytes_total,
+             gc9503->init_cmds ? "" : " from packed blob", (long long)(esp_timer_get_time() - start_us),
+             (unsigned long)delay_ms_total);
     ESP_LOGD(TAG, "send init commands success");
 
     return ESP_OK;
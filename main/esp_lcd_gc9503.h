@@ -27,7 +27,7 @@ typedef struct {
     int cmd;                /*<! The specific LCD command */
     const void *data;       /*<! Buffer that holds the command specific data */
     size_t data_bytes;      /*<! Size of `data` in memory, in bytes */
-    unsigned int delay_ms;  /*<! Delay in milliseconds after this command */
+    unsigned int delay_ms;  /*<! Delay in milliseconds after this command, 0 for none */
 } gc9503_lcd_init_cmd_t;
 
 /**
@@ -40,7 +40,7 @@ typedef struct {
     const esp_lcd_rgb_panel_config_t *rgb_config;   /*!< RGB panel configuration */
     const gc9503_lcd_init_cmd_t *init_cmds;         /*!< Pointer to initialization commands array. Set to NULL if using default commands.
                                                      *   The array should be declared as `static const` and positioned outside the function.
-                                                     *   Please refer to `vendor_specific_init_default` in source file.
+                                                     *   Please refer to `kInitCmds` in esp_lcd_gc9503_init.cc.
                                                      */
     uint16_t init_cmds_size;                        /*<! Number of commands in above array */
     struct {
@@ -120,6 +120,11 @@ esp_err_t esp_lcd_new_panel_gc9503(const esp_lcd_panel_io_handle_t io, const esp
         .vsync_front_porch = 20,                    \
 
  */
+#define GC9503_376_960_PANEL_H_TOTAL (376 + 8 + 30 + 30)
+#define GC9503_376_960_PANEL_V_TOTAL (960 + 8 + 16 + 16)
+// Pixel clock for a refresh rate with the porches below, 16 MHz as configured gives about 36 Hz
+#define GC9503_376_960_PANEL_PCLK_HZ(fps) ((uint32_t)(fps) * GC9503_376_960_PANEL_H_TOTAL * GC9503_376_960_PANEL_V_TOTAL)
+
 #define GC9503_376_960_PANEL_60HZ_RGB_TIMING()      \
     {                                               \
         .pclk_hz = 16 * 1000 * 1000,                \
@@ -0,0 +1,152 @@
+#include "esp_lcd_gc9503_init.h"
+#include <array>
+#include <initializer_list>
+
+// Largest payload in the table, the gamma curves
+static constexpr size_t kMaxDataBytes = 52;
+static_assert(kMaxDataBytes <= GC9503_INIT_BLOB_SIZE_MASK, "payload size must fit the flags byte");
+
+struct InitCmd
+{
+    uint8_t cmd;
+    uint8_t data_bytes;
+    uint8_t delay_ms;
+    std::array<uint8_t, kMaxDataBytes> data;
+};
+
+static constexpr InitCmd Cmd(uint8_t cmd, std::initializer_list<uint8_t> data, uint8_t delay_ms = 0)
+{
+    InitCmd init_cmd{cmd, static_cast<uint8_t>(data.size()), delay_ms, {}};
+    size_t i = 0;
+    for (uint8_t byte : data)
+    {
+        init_cmd.data[i++] = byte;
+    }
+    return init_cmd;
+}
+
+static constexpr InitCmd Cmd(uint8_t cmd, const std::array<uint8_t, kMaxDataBytes> &data)
+{
+    return InitCmd{cmd, kMaxDataBytes, 0, data};
+}
+
+static constexpr bool SameData(const InitCmd &a, const InitCmd &b)
+{
+    if (a.data_bytes != b.data_bytes)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.data_bytes; i++)
+    {
+        if (a.data[i] != b.data[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <size_t N>
+static constexpr size_t PackedSize(const InitCmd (&cmds)[N])
+{
+    size_t size = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        bool repeat = i > 0 && cmds[i].data_bytes > 0 && SameData(cmds[i], cmds[i - 1]);
+        size += 2 + (repeat ? 0 : cmds[i].data_bytes) + (cmds[i].delay_ms ? 1 : 0);
+    }
+    return size;
+}
+
+template <size_t Size, size_t N>
+static constexpr std::array<uint8_t, Size> Pack(const InitCmd (&cmds)[N])
+{
+    std::array<uint8_t, Size> blob{};
+    size_t pos = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        bool repeat = i > 0 && cmds[i].data_bytes > 0 && SameData(cmds[i], cmds[i - 1]);
+        blob[pos++] = cmds[i].cmd;
+        blob[pos++] = cmds[i].data_bytes | (repeat ? GC9503_INIT_BLOB_REPEAT : 0) |
+                      (cmds[i].delay_ms ? GC9503_INIT_BLOB_DELAY : 0);
+        for (size_t j = 0; !repeat && j < cmds[i].data_bytes; j++)
+        {
+            blob[pos++] = cmds[i].data[j];
+        }
+        if (cmds[i].delay_ms)
+        {
+            blob[pos++] = cmds[i].delay_ms;
+        }
+    }
+    return blob;
+}
+
+template <size_t N>
+static constexpr size_t UnpackedSize(const InitCmd (&cmds)[N])
+{
+    size_t size = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        size += cmds[i].data_bytes;
+    }
+    return size;
+}
+
+// The same curve is written to all six gamma registers (0xD1-0xD6)
+static constexpr std::array<uint8_t, kMaxDataBytes> kGammaCurve = {
+    0x00, 0x00, 0x00, 0x70, 0x00, 0x8f, 0x00, 0xab, 0x00, 0xbf, 0x00, 0xdf, 0x00, 0xfa,
+    0x01, 0x2a, 0x01, 0x52, 0x01, 0x90, 0x01, 0xc1, 0x02, 0x0e, 0x02, 0x4f, 0x02, 0x51,
+    0x02, 0x8d, 0x02, 0xd3, 0x02, 0xff, 0x03, 0x3c, 0x03, 0x64, 0x03, 0xa1, 0x03, 0xf1,
+    0x03, 0xff, 0x03, 0xff, 0x03, 0xff, 0x03, 0xff, 0x03, 0xff};
+
+// *INDENT-OFF*
+static constexpr InitCmd kInitCmds[] = {
+//  Cmd(cmd, { data }, delay_ms)
+    Cmd(0xF0, {0x55, 0xAA, 0x52, 0x08, 0x00}),
+    Cmd(0xF6, {0x5A, 0x87}),
+    Cmd(0xC1, {0x3F}),
+    Cmd(0xCD, {0x25}),
+    Cmd(0xC9, {0x10}),
+    Cmd(0xF8, {0x8A}),
+    Cmd(0xAC, {0x45}),
+    Cmd(0xA7, {0x47}),
+    Cmd(0xA0, {0x88}),
+    Cmd(0x86, {0x99, 0xA3, 0xA3, 0x51}),
+    Cmd(0xFA, {0x08, 0x08, 0x00, 0x04}),
+    Cmd(0xA3, {0x6E}),
+    Cmd(0xFD, {0x28, 0x3C, 0x00}),
+    Cmd(0x9A, {0x4B}),
+    Cmd(0x9B, {0x4B}),
+    Cmd(0x82, {0x20, 0x20}),
+    Cmd(0xB1, {0x10}),
+    Cmd(0x7A, {0x0F, 0x13}),
+    Cmd(0x7B, {0x0F, 0x13}),
+    Cmd(0x6D, {0x1e, 0x1e, 0x04, 0x02, 0x0d, 0x1e, 0x12, 0x11, 0x14, 0x13, 0x05, 0x06, 0x1d, 0x1e, 0x1e, 0x1e,
+               0x1e, 0x1e, 0x1e, 0x1d, 0x06, 0x05, 0x0b, 0x0c, 0x09, 0x0a, 0x1e, 0x0d, 0x01, 0x03, 0x1e, 0x1e}),
+    Cmd(0x64, {0x38, 0x08, 0x03, 0xc0, 0x03, 0x03, 0x38, 0x06, 0x03, 0xc2, 0x03, 0x03, 0x20, 0x6d, 0x20, 0x6d}),
+    Cmd(0x65, {0x38, 0x04, 0x03, 0xc4, 0x03, 0x03, 0x38, 0x02, 0x03, 0xc6, 0x03, 0x03, 0x20, 0x6d, 0x20, 0x6d}),
+    Cmd(0x66, {0x83, 0xcf, 0x03, 0xc8, 0x03, 0x03, 0x83, 0xd3, 0x03, 0xd2, 0x03, 0x03, 0x20, 0x6d, 0x20, 0x6d}),
+    Cmd(0x60, {0x38, 0x0C, 0x20, 0x6D, 0x38, 0x0B, 0x20, 0x6D}),
+    Cmd(0x61, {0x38, 0x0A, 0x20, 0x6D, 0x38, 0x09, 0x20, 0x6D}),
+    Cmd(0x62, {0x38, 0x25, 0x20, 0x6D, 0x63, 0xC9, 0x20, 0x6D}),
+    Cmd(0x69, {0x14, 0x22, 0x14, 0x22, 0x14, 0x22, 0x08}),
+    Cmd(0x6B, {0x07}),
+    Cmd(0xD1, kGammaCurve),
+    Cmd(0xD2, kGammaCurve),
+    Cmd(0xD3, kGammaCurve),
+    Cmd(0xD4, kGammaCurve),
+    Cmd(0xD5, kGammaCurve),
+    Cmd(0xD6, kGammaCurve),
+
+    Cmd(0x11, {}, 120), // Sleep out, the panel needs 120 ms before the next command
+    // Display on is the last command, the delay only covers the panel settling as in the vendor reference sequence
+    Cmd(0x29, {}, 20),
+};
+// *INDENT-ON*
+
+static constexpr size_t kBlobSize = PackedSize(kInitCmds);
+static constexpr auto kBlob = Pack<kBlobSize>(kInitCmds);
+static_assert(kBlobSize < UnpackedSize(kInitCmds), "repeated payloads are stored once");
+
+extern "C" const uint8_t *const gc9503_default_init_blob = kBlob.data();
+extern "C" const size_t gc9503_default_init_blob_size = kBlobSize;
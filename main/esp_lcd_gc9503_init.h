@@ -0,0 +1,32 @@
+/**
+ * @file
+ * @brief Packed default GC9503 initialization sequence
+ *
+ * The blob is generated at compile time in esp_lcd_gc9503_init.cc. Every
+ * command is encoded as
+ *
+ *     cmd, flags | data_bytes, [data...], [delay_ms]
+ *
+ * `GC9503_INIT_BLOB_REPEAT` means the data equals the previous command's data
+ * and is not stored again, `GC9503_INIT_BLOB_DELAY` means a delay byte follows.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GC9503_INIT_BLOB_SIZE_MASK (0x3F)
+#define GC9503_INIT_BLOB_REPEAT (1 << 6)
+#define GC9503_INIT_BLOB_DELAY (1 << 7)
+
+extern const uint8_t *const gc9503_default_init_blob;
+extern const size_t gc9503_default_init_blob_size;
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,16 +4,42 @@
 #include <nvs_flash.h>
 #include <driver/gpio.h>
 #include <esp_event.h>
+#include <esp_pm.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <esp_lvgl_port.h>
 
+#include "config.h"
+#include "boot_trace.h"
 #include "board/board.h"
 #include "display/display.h"
+#include "display/rgb565_rotate.h"
+#include "display/rgb565_blend.h"
+#include "display/rgb565_dither.h"
+#include "display/band_scheduler.h"
+#include "display/image_assets.h"
 #include "backlight/backlight.h"
 #include "audio/dummy_audio_codec.h"
 
 #define TAG "main"
 
+// Let DFS lower the CPU clock whenever no activity lock is held. Light sleep stays off, the RGB
+// panel has to be fed from PSRAM continuously.
+static void configure_power_management()
+{
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = PM_MIN_CPU_FREQ_MHZ,
+        .light_sleep_enable = false,
+    };
+    ESP_ERROR_CHECK(esp_pm_configure(&pm_config));
+    ESP_LOGI(TAG, "DFS enabled: %d-%d MHz", PM_MIN_CPU_FREQ_MHZ, CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#else
+    ESP_LOGI(TAG, "CONFIG_PM_ENABLE is off, CPU stays at full speed");
+#endif
+}
+
 // Simple display initialization - no complex locking or tasks needed
 static void setup_simple_display()
 {
@@ -35,9 +61,8 @@ static void setup_simple_display()
     {
         ESP_LOGI(TAG, "Display available: %dx%d", display->width(), display->height());
 
-        // Wait for LVGL to initialize
-        ESP_LOGI(TAG, "Waiting for LVGL to initialize...");
-        vTaskDelay(pdMS_TO_TICKS(3000));
+        // LVGL is ready once the board is constructed, the LVGL task only needs to be locked out
+        lvgl_port_lock(0);
 
         ESP_LOGI(TAG, "Creating simple demo label...");
         // Create a simple demo label directly with LVGL - no Display wrapper
@@ -65,6 +90,17 @@ static void setup_simple_display()
             lv_obj_set_style_border_color(bg, lv_color_hex(0x0080FF), 0);
             ESP_LOGI(TAG, "Background element created");
         }
+
+        // Logo from the assets partition, if one was packed
+        const lv_image_dsc_t *logo = ImageAssets::GetInstance().Get("logo");
+        if (logo)
+        {
+            lv_obj_t *image = lv_image_create(lv_screen_active());
+            lv_image_set_src(image, logo);
+            lv_obj_align(image, LV_ALIGN_TOP_MID, 0, 40);
+        }
+
+        lvgl_port_unlock();
     }
     else
     {
@@ -76,12 +112,15 @@ static void setup_simple_display()
 
 extern "C" void app_main(void)
 {
+    auto &trace = BootTrace::GetInstance();
+    trace.Mark(BootPhase::kAppMain);
     ESP_LOGI(TAG, "Kevin Yuying 313 LCD MVP starting...");
 
     // Initialize the default event loop
     ESP_ERROR_CHECK(esp_event_loop_create_default());
 
     // Initialize NVS flash
+    trace.Begin(BootPhase::kNvsInit);
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND)
     {
@@ -90,6 +129,25 @@ extern "C" void app_main(void)
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+    trace.End(BootPhase::kNvsInit);
+
+    if (DISPLAY_ROTATE_BENCHMARK)
+    {
+        Rgb565RotateBenchmark();
+    }
+    if (DISPLAY_BLEND_BENCHMARK)
+    {
+        Rgb565BlendBenchmark();
+    }
+    if (DISPLAY_DITHER_BENCHMARK)
+    {
+        Rgb565DitherBenchmark();
+    }
+    if (DISPLAY_BAND_BENCHMARK)
+    {
+        BandSchedulerBenchmark();
+        BandScheduler::GetInstance().set_parallel(DISPLAY_PARALLEL_BANDS);
+    }
 
     ESP_LOGI(TAG, "Initializing board...");
     // Get board instance - this will initialize the hardware
@@ -113,6 +171,9 @@ extern "C" void app_main(void)
     // Simple display setup - no separate task needed
     setup_simple_display();
 
+    // Boot ran at full speed, from here on the activity locks decide
+    configure_power_management();
+
     ESP_LOGI(TAG, "MVP initialization complete. System running.");
 
     // Simple main loop - just keep the system alive
@@ -0,0 +1,185 @@
+#include "pm_activity.h"
+#include <esp_log.h>
+#include <esp_err.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+#include <cstdio>
+
+#define TAG "PmActivity"
+
+// Accounting across all activity locks, guarded by global_lock
+static portMUX_TYPE global_lock = portMUX_INITIALIZER_UNLOCKED;
+static PmActivityLock *registered_locks[PmActivityLock::kMaxLocks];
+static int global_held = 0;
+static int64_t global_start_us = -1;
+static int64_t global_held_since_us = 0;
+static int64_t global_active_us = 0;
+static int type_held[kPmLockTypes];
+static int64_t type_held_since_us[kPmLockTypes];
+static int64_t type_active_us[kPmLockTypes];
+
+PmActivityLock::PmActivityLock(esp_pm_lock_type_t type, const char *name) : name_(name), type_(type)
+{
+    esp_err_t ret = esp_pm_lock_create(type, 0, name, &handle_);
+    if (ret == ESP_ERR_NOT_SUPPORTED)
+    {
+        ESP_LOGI(TAG, "Power management not supported, %s only counts activity", name);
+        handle_ = nullptr;
+    }
+    else
+    {
+        ESP_ERROR_CHECK(ret);
+    }
+
+    portENTER_CRITICAL(&global_lock);
+    if (global_start_us < 0)
+    {
+        global_start_us = esp_timer_get_time();
+    }
+    for (auto &slot : registered_locks)
+    {
+        if (slot == nullptr)
+        {
+            slot = this;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&global_lock);
+}
+
+PmActivityLock::~PmActivityLock()
+{
+    portENTER_CRITICAL(&global_lock);
+    for (auto &slot : registered_locks)
+    {
+        if (slot == this)
+        {
+            slot = nullptr;
+        }
+    }
+    portEXIT_CRITICAL(&global_lock);
+
+    while (held_ > 0)
+    {
+        Release();
+    }
+    if (handle_ != nullptr)
+    {
+        esp_pm_lock_delete(handle_);
+    }
+}
+
+IRAM_ATTR void PmActivityLock::Acquire()
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&lock_);
+    if (held_++ == 0)
+    {
+        held_since_us_ = now;
+        activations_++;
+        if (handle_ != nullptr)
+        {
+            esp_pm_lock_acquire(handle_);
+        }
+
+        portENTER_CRITICAL_SAFE(&global_lock);
+        if (global_held++ == 0)
+        {
+            global_held_since_us = now;
+        }
+        if (type_held[type_]++ == 0)
+        {
+            type_held_since_us[type_] = now;
+        }
+        portEXIT_CRITICAL_SAFE(&global_lock);
+    }
+    portEXIT_CRITICAL_SAFE(&lock_);
+}
+
+IRAM_ATTR void PmActivityLock::Release()
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&lock_);
+    if (held_ > 0 && --held_ == 0)
+    {
+        active_us_ += now - held_since_us_;
+        if (handle_ != nullptr)
+        {
+            esp_pm_lock_release(handle_);
+        }
+
+        portENTER_CRITICAL_SAFE(&global_lock);
+        if (--global_held == 0)
+        {
+            global_active_us += now - global_held_since_us;
+        }
+        if (--type_held[type_] == 0)
+        {
+            type_active_us[type_] += now - type_held_since_us[type_];
+        }
+        portEXIT_CRITICAL_SAFE(&global_lock);
+    }
+    portEXIT_CRITICAL_SAFE(&lock_);
+}
+
+int64_t PmActivityLock::GetActiveUs()
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&lock_);
+    int64_t active_us = active_us_ + (held_ > 0 ? now - held_since_us_ : 0);
+    portEXIT_CRITICAL(&lock_);
+    return active_us;
+}
+
+PmActivityStats PmActivityLock::GetStats()
+{
+    PmActivityStats stats;
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&global_lock);
+    if (global_start_us >= 0)
+    {
+        stats.total_us = now - global_start_us;
+        stats.active_us = global_active_us + (global_held > 0 ? now - global_held_since_us : 0);
+        stats.idle_us = stats.total_us - stats.active_us;
+        for (int type = 0; type < kPmLockTypes; type++)
+        {
+            stats.type_us[type] = type_active_us[type] + (type_held[type] > 0 ? now - type_held_since_us[type] : 0);
+        }
+    }
+    portEXIT_CRITICAL(&global_lock);
+    return stats;
+}
+
+void PmActivityLock::LogSummary()
+{
+    PmActivityStats stats = GetStats();
+    if (stats.total_us <= 0)
+    {
+        return;
+    }
+
+    PmActivityLock *locks[kMaxLocks];
+    portENTER_CRITICAL(&global_lock);
+    for (int i = 0; i < kMaxLocks; i++)
+    {
+        locks[i] = registered_locks[i];
+    }
+    portEXIT_CRITICAL(&global_lock);
+
+    char line[160];
+    int len = 0;
+    for (auto *lock : locks)
+    {
+        if (lock != nullptr && len < (int)sizeof(line))
+        {
+            len += snprintf(line + len, sizeof(line) - len, "%s %.1f%% (%lu), ", lock->name(),
+                            lock->GetActiveUs() * 100.0f / stats.total_us, (unsigned long)lock->GetActivations());
+        }
+    }
+    ESP_LOGI(TAG, "%sidle %.1f%% of %lld s", len > 0 ? line : "", stats.idle_us * 100.0f / stats.total_us,
+             (long long)(stats.total_us / 1000000));
+    ESP_LOGI(TAG, "by lock type: CPU_FREQ_MAX %.1f%%, APB_FREQ_MAX %.1f%%, NO_LIGHT_SLEEP %.1f%%",
+             stats.type_us[ESP_PM_CPU_FREQ_MAX] * 100.0f / stats.total_us,
+             stats.type_us[ESP_PM_APB_FREQ_MAX] * 100.0f / stats.total_us,
+             stats.type_us[ESP_PM_NO_LIGHT_SLEEP] * 100.0f / stats.total_us);
+}
@@ -0,0 +1,55 @@
+#ifndef PM_ACTIVITY_H
+#define PM_ACTIVITY_H
+
+#include <cstdint>
+#include <esp_pm.h>
+#include <freertos/FreeRTOS.h>
+
+// esp_pm_lock_type_t values: CPU_FREQ_MAX, APB_FREQ_MAX, NO_LIGHT_SLEEP
+static constexpr int kPmLockTypes = ESP_PM_NO_LIGHT_SLEEP + 1;
+
+// Time split between "some activity lock held" and "idle, DFS may run at the minimum frequency"
+struct PmActivityStats
+{
+    int64_t total_us = 0; // since the first activity lock was created
+    int64_t active_us = 0;
+    int64_t idle_us = 0;
+    // Per esp_pm_lock_type_t, time at least one lock of that type was held: CPU_FREQ_MAX is the
+    // residency at the maximum CPU frequency, APB_FREQ_MAX at no less than 80 MHz APB
+    int64_t type_us[kPmLockTypes] = {};
+};
+
+// esp_pm lock that is only held while a piece of work runs (rendering, scan-out lookups, ...) and
+// keeps track of how long it was held. Acquire/Release nest and may be called from an ISR. Without
+// CONFIG_PM_ENABLE the esp_pm lock is skipped but the time accounting still works.
+class PmActivityLock
+{
+public:
+    static constexpr int kMaxLocks = 4;
+
+    PmActivityLock(esp_pm_lock_type_t type, const char *name);
+    ~PmActivityLock();
+
+    void Acquire();
+    void Release();
+
+    const char *name() const { return name_; }
+    int64_t GetActiveUs();
+    uint32_t GetActivations() const { return activations_; }
+
+    static PmActivityStats GetStats();
+    // The share of time each lock was held and the idle share, then the share per lock type
+    static void LogSummary();
+
+private:
+    const char *name_;
+    esp_pm_lock_type_t type_;
+    esp_pm_lock_handle_t handle_ = nullptr;
+    portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+    int held_ = 0;
+    int64_t held_since_us_ = 0;
+    int64_t active_us_ = 0;
+    uint32_t activations_ = 0;
+};
+
+#endif // PM_ACTIVITY_H
@@ -0,0 +1,62 @@
+// Host runner of the kernel benchmarks: runs the ones named on the command line, or all of them,
+// and exits with the number of failed checks so ctest catches a kernel that drifts from its
+// reference
+#include "band_scheduler.h"
+#include "rgb565_blend.h"
+#include "rgb565_dither.h"
+#include "rgb565_rotate.h"
+#include <cstdio>
+#include <cstring>
+
+struct KernelBench
+{
+    const char *name;
+    int (*run)();
+};
+
+static const KernelBench kBenches[] = {
+    {"rotate", Rgb565RotateBenchmark},
+    {"blend", Rgb565BlendBenchmark},
+    {"dither", Rgb565DitherBenchmark},
+    {"band", BandSchedulerBenchmark},
+};
+
+static bool Named(int argc, char **argv, const char *name)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    int named = 0;
+    for (const auto &bench : kBenches)
+    {
+        named += Named(argc, argv, bench.name) ? 1 : 0;
+    }
+    if (named != argc - 1)
+    {
+        fprintf(stderr, "usage: %s [rotate|blend|dither|band]...\n", argv[0]);
+        return 2;
+    }
+
+    int failures = 0;
+    for (const auto &bench : kBenches)
+    {
+        if (argc == 1 || Named(argc, argv, bench.name))
+        {
+            failures += bench.run();
+        }
+    }
+    if (failures > 0)
+    {
+        fprintf(stderr, "%d kernel check(s) failed\n", failures);
+    }
+    return failures;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// Host stand-in for ESP-IDF <esp_event.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t esp_event_loop_create_default(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+// Host stand-in for espressif/esp_lcd_panel_io_additions. The simulated
+// 3-wire SPI IO logs every command so init sequences can be inspected.
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PANEL_IO_3WIRE_SPI_CLK_MAX (500 * 1000UL)
+
+typedef enum
+{
+    IO_TYPE_GPIO = 0,
+    IO_TYPE_EXPANDER,
+} io_type_t;
+
+typedef struct
+{
+    io_type_t cs_io_type;
+    int cs_gpio_num;
+    io_type_t scl_io_type;
+    int scl_gpio_num;
+    io_type_t sda_io_type;
+    int sda_gpio_num;
+    void *io_expander;
+} spi_line_config_t;
+
+typedef struct
+{
+    spi_line_config_t line_config;
+    uint32_t expect_clk_speed;
+    uint32_t spi_mode;
+    uint32_t lcd_cmd_bytes;
+    uint32_t lcd_param_bytes;
+    struct
+    {
+        uint32_t use_dc_bit : 1;
+        uint32_t dc_zero_on_data : 1;
+        uint32_t lsb_first : 1;
+        uint32_t cs_high_active : 1;
+        uint32_t del_keep_cs_inactive : 1;
+    } flags;
+} esp_lcd_panel_io_3wire_spi_config_t;
+
+esp_err_t esp_lcd_new_panel_io_3wire_spi(const esp_lcd_panel_io_3wire_spi_config_t *io_config, esp_lcd_panel_io_handle_t *ret_io);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+// Host stand-in for ESP-IDF <esp_lcd_types.h>
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+
+typedef enum
+{
+    LCD_RGB_ELEMENT_ORDER_RGB = 0,
+    LCD_RGB_ELEMENT_ORDER_BGR = 1,
+} lcd_rgb_element_order_t;
+
+typedef enum
+{
+    LCD_CLK_SRC_DEFAULT = 0,
+    LCD_CLK_SRC_PLL160M,
+    LCD_CLK_SRC_PLL240M,
+    LCD_CLK_SRC_XTAL,
+} lcd_clock_source_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+// Host stand-in for espressif/esp_lvgl_port 2.x. Only the API surface this
+// project uses is provided: the LVGL task, the port lock and RGB displays.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    int task_priority;
+    int task_stack;
+    int task_affinity;
+    int task_max_sleep_ms;
+    int timer_period_ms;
+} lvgl_port_cfg_t;
+
+#define ESP_LVGL_PORT_INIT_CONFIG() \
+    {                               \
+        .task_priority = 4,         \
+        .task_stack = 7168,         \
+        .task_affinity = -1,        \
+        .task_max_sleep_ms = 500,   \
+        .timer_period_ms = 5,       \
+    }
+
+typedef struct
+{
+    bool swap_xy;
+    bool mirror_x;
+    bool mirror_y;
+} lvgl_port_rotation_cfg_t;
+
+typedef struct
+{
+    esp_lcd_panel_io_handle_t io_handle;
+    esp_lcd_panel_handle_t panel_handle;
+    esp_lcd_panel_handle_t control_handle;
+    uint32_t buffer_size;
+    bool double_buffer;
+    uint32_t trans_size;
+    uint32_t hres;
+    uint32_t vres;
+    bool monochrome;
+    lvgl_port_rotation_cfg_t rotation;
+    lv_color_format_t color_format;
+    struct
+    {
+        unsigned int buff_dma : 1;
+        unsigned int buff_spiram : 1;
+        unsigned int sw_rotate : 1;
+        unsigned int swap_bytes : 1;
+        unsigned int full_refresh : 1;
+        unsigned int direct_mode : 1;
+    } flags;
+} lvgl_port_display_cfg_t;
+
+typedef struct
+{
+    struct
+    {
+        unsigned int bb_mode : 1;
+        unsigned int avoid_tearing : 1;
+    } flags;
+} lvgl_port_display_rgb_cfg_t;
+
+esp_err_t lvgl_port_init(const lvgl_port_cfg_t *cfg);
+esp_err_t lvgl_port_deinit(void);
+bool lvgl_port_lock(uint32_t timeout_ms);
+void lvgl_port_unlock(void);
+lv_display_t *lvgl_port_add_disp_rgb(const lvgl_port_display_cfg_t *disp_cfg, const lvgl_port_display_rgb_cfg_t *rgb_cfg);
+esp_err_t lvgl_port_remove_disp(lv_display_t *disp);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,12 @@
+#pragma once
+
+// Host stand-in for ESP-IDF <esp_memory_utils.h>. Host memory is all one kind,
+// none of it counts as external RAM behind a cache.
+
+#include <stdbool.h>
+
+static inline bool esp_ptr_external_ram(const void *p)
+{
+    (void)p;
+    return false;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF FreeRTOS port. Tasks map onto host threads,
+// ticks are milliseconds (CONFIG_FREERTOS_HZ=1000 in sdkconfig.defaults) and
+// "ISR" variants are ordinary calls made from the simulated peripheral threads.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t StackType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+#define pdTICKS_TO_MS(xTicks) ((TickType_t)(((uint64_t)(xTicks) * 1000U) / configTICK_RATE_HZ))
+
+#define portNUM_PROCESSORS 2
+#define configMAX_PRIORITIES 25
+#define tskNO_AFFINITY ((BaseType_t)0x7FFFFFFF)
+
+typedef struct
+{
+    volatile int owner;
+    volatile int count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+
+void sim_port_enter_critical(portMUX_TYPE *mux);
+void sim_port_exit_critical(portMUX_TYPE *mux);
+BaseType_t xPortGetCoreID(void);
+
+#define portENTER_CRITICAL(mux) sim_port_enter_critical(mux)
+#define portEXIT_CRITICAL(mux) sim_port_exit_critical(mux)
+#define portENTER_CRITICAL_ISR(mux) sim_port_enter_critical(mux)
+#define portEXIT_CRITICAL_ISR(mux) sim_port_exit_critical(mux)
+#define portENTER_CRITICAL_SAFE(mux) sim_port_enter_critical(mux)
+#define portEXIT_CRITICAL_SAFE(mux) sim_port_exit_critical(mux)
+#define portYIELD_FROM_ISR(x) ((void)(x))
+
+#ifdef __cplusplus
+}
+#endif
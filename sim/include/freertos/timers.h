@@ -0,0 +1,21 @@
+#pragma once
+
+// Host stand-in for <freertos/timers.h>, only the deferred function calls the
+// firmware uses. The "timer task" is a fresh host thread per call.
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*PendedFunction_t)(void *, uint32_t);
+
+BaseType_t xTimerPendFunctionCall(PendedFunction_t function_to_pend, void *parameter1, uint32_t parameter2,
+                                  TickType_t ticks_to_wait);
+BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t function_to_pend, void *parameter1, uint32_t parameter2,
+                                         BaseType_t *higher_priority_task_woken);
+
+#ifdef __cplusplus
+}
+#endif
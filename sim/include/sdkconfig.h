@@ -0,0 +1,4 @@
+#pragma once
+
+// Host stand-in for the generated <sdkconfig.h>. No CONFIG_IDF_TARGET_* is set,
+// so target specific code paths fall back to their portable versions.
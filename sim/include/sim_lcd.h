@@ -0,0 +1,32 @@
+#pragma once
+
+// Simulator-only helpers for inspecting the simulated RGB panel.
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Last RGB panel created through esp_lcd_new_rgb_panel(), or NULL
+ */
+esp_lcd_panel_handle_t sim_lcd_get_rgb_panel(void);
+
+/**
+ * @brief Write the frame currently being scanned out to a binary PPM (P6) file
+ *
+ * RGB565 pixels are expanded to 8 bits per channel.
+ */
+esp_err_t sim_lcd_dump_ppm(esp_lcd_panel_handle_t panel, const char *path);
+
+/**
+ * @brief Number of frames the simulated panel has scanned out so far
+ */
+uint32_t sim_lcd_get_frame_count(esp_lcd_panel_handle_t panel);
+
+#ifdef __cplusplus
+}
+#endif
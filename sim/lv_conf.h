@@ -0,0 +1,43 @@
+/**
+ * LVGL configuration for the host simulator.
+ *
+ * Mirrors the LVGL options in sdkconfig.defaults so the host build renders
+ * with the same settings as the device. Anything not listed here keeps the
+ * LVGL default from lv_conf_internal.h.
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH 16
+
+#define LV_USE_STDLIB_MALLOC LV_STDLIB_CLIB
+#define LV_USE_STDLIB_STRING LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF LV_STDLIB_CLIB
+
+#define LV_USE_OS LV_OS_NONE
+
+#define LV_USE_DRAW_SW_ASM LV_DRAW_SW_ASM_CUSTOM
+#define LV_DRAW_SW_ASM_CUSTOM_INCLUDE "rgb565_blend_lvgl.h"
+
+#define LV_FONT_FMT_TXT_LARGE 1
+#define LV_USE_FONT_COMPRESSED 1
+#define LV_USE_FONT_PLACEHOLDER 1
+
+#define LV_USE_ANIMIMG 0
+#define LV_USE_CALENDAR 0
+#define LV_USE_CHART 0
+#define LV_USE_KEYBOARD 0
+#define LV_USE_LED 0
+#define LV_USE_LIST 0
+#define LV_USE_MENU 0
+#define LV_USE_MSGBOX 0
+#define LV_USE_SPAN 0
+#define LV_USE_SPINBOX 0
+#define LV_USE_SPINNER 0
+#define LV_USE_TABVIEW 0
+#define LV_USE_TILEVIEW 0
+#define LV_USE_WIN 0
+
+#define LV_BUILD_EXAMPLES 0
+
+#endif // LV_CONF_H
@@ -0,0 +1,110 @@
+// GDMA memory-copy engine backed by a worker thread: transfers are copied in
+// submission order and the done callback runs on the worker, so callers that
+// forget to wait for a transfer race with it just as they would on the target
+
+#include <esp_async_memcpy.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    struct Transfer
+    {
+        void *dst;
+        const void *src;
+        size_t n;
+        async_memcpy_isr_cb_t cb;
+        void *cb_args;
+    };
+}
+
+struct async_memcpy_context_t
+{
+    uint32_t backlog;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Transfer> queue;
+    bool stop = false;
+    std::thread worker;
+};
+
+static void Worker(async_memcpy_context_t *mcp)
+{
+    for (;;)
+    {
+        Transfer transfer;
+        {
+            std::unique_lock<std::mutex> lock(mcp->mutex);
+            mcp->cv.wait(lock, [mcp]
+                         { return mcp->stop || !mcp->queue.empty(); });
+            if (mcp->queue.empty())
+            {
+                return;
+            }
+            transfer = mcp->queue.front();
+        }
+        memcpy(transfer.dst, transfer.src, transfer.n);
+        {
+            // Leaves the queue only once copied, the slot is busy until then
+            std::lock_guard<std::mutex> lock(mcp->mutex);
+            mcp->queue.pop_front();
+        }
+        if (transfer.cb != nullptr)
+        {
+            async_memcpy_event_t event = {};
+            transfer.cb(mcp, &event, transfer.cb_args);
+        }
+    }
+}
+
+extern "C" esp_err_t esp_async_memcpy_install(const async_memcpy_config_t *config, async_memcpy_handle_t *mcp)
+{
+    if (config == nullptr || mcp == nullptr || config->backlog == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto *context = new async_memcpy_context_t;
+    context->backlog = config->backlog;
+    context->worker = std::thread(Worker, context);
+    *mcp = context;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_async_memcpy_uninstall(async_memcpy_handle_t mcp)
+{
+    if (mcp == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mcp->mutex);
+        mcp->stop = true;
+    }
+    mcp->cv.notify_one();
+    mcp->worker.join();
+    delete mcp;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_async_memcpy(async_memcpy_handle_t mcp, void *dst, void *src, size_t n,
+                                      async_memcpy_isr_cb_t cb_isr, void *cb_args)
+{
+    if (mcp == nullptr || dst == nullptr || src == nullptr || n == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mcp->mutex);
+        if (mcp->queue.size() >= mcp->backlog)
+        {
+            return ESP_ERR_INVALID_STATE;
+        }
+        mcp->queue.push_back({dst, src, n, cb_isr, cb_args});
+    }
+    mcp->cv.notify_one();
+    return ESP_OK;
+}
@@ -0,0 +1,534 @@
+// Host stand-in for esp_lcd: the generic panel/IO dispatch, the 3-wire SPI
+// panel IO from esp_lcd_panel_io_additions and the RGB panel driver.
+//
+// The RGB panel owns plain heap frame buffers and a scan-out thread that runs
+// at the refresh rate implied by the timing (pclk / htotal / vtotal). Every
+// frame it latches a pending frame-buffer switch, fires on_vsync, walks the
+// frame in bounce-buffer sized chunks (calling on_bounce_empty when the panel
+// has no frame buffer) and finally fires on_bounce_frame_finish. The last
+// scanned-out frame is kept so it can be dumped with sim_lcd_dump_ppm().
+
+#include <esp_lcd_panel_io.h>
+#include <esp_lcd_panel_ops.h>
+#include <esp_lcd_panel_rgb.h>
+#include <esp_lcd_panel_interface.h>
+#include <esp_lcd_panel_io_additions.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <sim_lcd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define TAG "sim_lcd"
+
+// Generic panel IO dispatch
+
+extern "C" esp_err_t esp_lcd_panel_io_rx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, void *param, size_t param_size)
+{
+    if (io == nullptr || io->rx_param == nullptr)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return io->rx_param(io, lcd_cmd, param, param_size);
+}
+
+extern "C" esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *param, size_t param_size)
+{
+    if (io == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return io->tx_param(io, lcd_cmd, param, param_size);
+}
+
+extern "C" esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *color, size_t color_size)
+{
+    if (io == nullptr || io->tx_color == nullptr)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return io->tx_color(io, lcd_cmd, color, color_size);
+}
+
+extern "C" esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io)
+{
+    if (io == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return io->del(io);
+}
+
+// 3-wire SPI panel IO: commands are counted, nothing is transmitted
+
+namespace
+{
+    struct Sim3WireIo
+    {
+        esp_lcd_panel_io_t base;
+        size_t commands;
+        size_t param_bytes;
+    };
+} // namespace
+
+static esp_err_t sim_3wire_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size)
+{
+    auto *spi = reinterpret_cast<Sim3WireIo *>(io);
+    spi->commands++;
+    spi->param_bytes += param_size;
+    return ESP_OK;
+}
+
+static esp_err_t sim_3wire_del(esp_lcd_panel_io_t *io)
+{
+    auto *spi = reinterpret_cast<Sim3WireIo *>(io);
+    ESP_LOGI(TAG, "3-wire SPI IO deleted after %zu commands, %zu parameter bytes", spi->commands, spi->param_bytes);
+    delete spi;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_lcd_new_panel_io_3wire_spi(const esp_lcd_panel_io_3wire_spi_config_t *io_config, esp_lcd_panel_io_handle_t *ret_io)
+{
+    if (io_config == nullptr || ret_io == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto *spi = new Sim3WireIo{};
+    spi->base.tx_param = sim_3wire_tx_param;
+    spi->base.del = sim_3wire_del;
+    *ret_io = &spi->base;
+    return ESP_OK;
+}
+
+// Generic panel dispatch
+
+extern "C" esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel)
+{
+    return panel->reset(panel);
+}
+
+extern "C" esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel)
+{
+    return panel->init(panel);
+}
+
+extern "C" esp_err_t esp_lcd_panel_del(esp_lcd_panel_handle_t panel)
+{
+    return panel->del(panel);
+}
+
+extern "C" esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    return panel->draw_bitmap(panel, x_start, y_start, x_end, y_end, color_data);
+}
+
+extern "C" esp_err_t esp_lcd_panel_mirror(esp_lcd_panel_handle_t panel, bool mirror_x, bool mirror_y)
+{
+    return panel->mirror ? panel->mirror(panel, mirror_x, mirror_y) : ESP_ERR_NOT_SUPPORTED;
+}
+
+extern "C" esp_err_t esp_lcd_panel_swap_xy(esp_lcd_panel_handle_t panel, bool swap_axes)
+{
+    return panel->swap_xy ? panel->swap_xy(panel, swap_axes) : ESP_ERR_NOT_SUPPORTED;
+}
+
+extern "C" esp_err_t esp_lcd_panel_set_gap(esp_lcd_panel_handle_t panel, int x_gap, int y_gap)
+{
+    return panel->set_gap ? panel->set_gap(panel, x_gap, y_gap) : ESP_ERR_NOT_SUPPORTED;
+}
+
+extern "C" esp_err_t esp_lcd_panel_invert_color(esp_lcd_panel_handle_t panel, bool invert_color_data)
+{
+    return panel->invert_color ? panel->invert_color(panel, invert_color_data) : ESP_ERR_NOT_SUPPORTED;
+}
+
+extern "C" esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel, bool on_off)
+{
+    return panel->disp_on_off ? panel->disp_on_off(panel, on_off) : ESP_ERR_NOT_SUPPORTED;
+}
+
+extern "C" esp_err_t esp_lcd_panel_disp_sleep(esp_lcd_panel_handle_t panel, bool sleep)
+{
+    return panel->disp_sleep ? panel->disp_sleep(panel, sleep) : ESP_ERR_NOT_SUPPORTED;
+}
+
+// RGB panel
+
+namespace
+{
+    constexpr int kMaxFrameBuffers = 3;
+
+    struct SimRgbPanel
+    {
+        esp_lcd_panel_t base; // must stay first, handles are cast back to SimRgbPanel
+        esp_lcd_rgb_panel_config_t config;
+        size_t bytes_per_pixel;
+        size_t fb_bytes;
+        int num_fbs;
+        uint8_t *fbs[kMaxFrameBuffers];
+        std::atomic<int> cur_fb;
+        std::atomic<int> pending_fb;
+        std::atomic<uint32_t> pclk_hz;
+        std::atomic<uint32_t> frame_count;
+        std::atomic<bool> running;
+        bool swap_xy;
+        bool mirror_x;
+        bool mirror_y;
+        esp_lcd_rgb_panel_event_callbacks_t callbacks;
+        void *user_ctx;
+        std::mutex scanout_mutex;
+        std::vector<uint8_t> scanout;
+        std::vector<uint8_t> bounce;
+        std::thread scan_thread;
+    };
+
+    std::atomic<SimRgbPanel *> last_rgb_panel{nullptr};
+
+    SimRgbPanel *ToSim(esp_lcd_panel_t *panel)
+    {
+        return reinterpret_cast<SimRgbPanel *>(panel);
+    }
+
+    int64_t FramePeriodUs(const SimRgbPanel *rgb)
+    {
+        const auto &t = rgb->config.timings;
+        uint64_t htotal = t.h_res + t.hsync_pulse_width + t.hsync_back_porch + t.hsync_front_porch;
+        uint64_t vtotal = t.v_res + t.vsync_pulse_width + t.vsync_back_porch + t.vsync_front_porch;
+        uint32_t pclk = rgb->pclk_hz.load();
+        return pclk ? static_cast<int64_t>(htotal * vtotal * 1000000ULL / pclk) : 16666;
+    }
+
+    void ScanOutFrame(SimRgbPanel *rgb)
+    {
+        esp_lcd_rgb_panel_event_data_t edata = {};
+        // Also orders the frame against callbacks registered while the panel runs
+        std::lock_guard<std::mutex> lock(rgb->scanout_mutex);
+        int pending = rgb->pending_fb.exchange(-1);
+        if (pending >= 0)
+        {
+            rgb->cur_fb = pending;
+        }
+        if (rgb->callbacks.on_vsync)
+        {
+            rgb->callbacks.on_vsync(&rgb->base, &edata, rgb->user_ctx);
+        }
+
+        const size_t total_px = rgb->config.timings.h_res * rgb->config.timings.v_res;
+        const size_t chunk_px = rgb->config.bounce_buffer_size_px ? rgb->config.bounce_buffer_size_px : total_px;
+        for (size_t pos_px = 0; pos_px < total_px; pos_px += chunk_px)
+        {
+            size_t len_px = std::min(chunk_px, total_px - pos_px);
+            size_t len_bytes = len_px * rgb->bytes_per_pixel;
+            uint8_t *dst = rgb->scanout.data() + pos_px * rgb->bytes_per_pixel;
+            if (rgb->num_fbs > 0)
+            {
+                std::memcpy(dst, rgb->fbs[rgb->cur_fb] + pos_px * rgb->bytes_per_pixel, len_bytes);
+            }
+            else if (rgb->callbacks.on_bounce_empty)
+            {
+                rgb->callbacks.on_bounce_empty(&rgb->base, rgb->bounce.data(), static_cast<int>(pos_px),
+                                               static_cast<int>(len_bytes), rgb->user_ctx);
+                std::memcpy(dst, rgb->bounce.data(), len_bytes);
+            }
+        }
+        rgb->frame_count++;
+        if (rgb->callbacks.on_bounce_frame_finish && rgb->config.bounce_buffer_size_px)
+        {
+            rgb->callbacks.on_bounce_frame_finish(&rgb->base, &edata, rgb->user_ctx);
+        }
+    }
+
+    void ScanThread(SimRgbPanel *rgb)
+    {
+        auto next = std::chrono::steady_clock::now();
+        while (rgb->running)
+        {
+            next += std::chrono::microseconds(FramePeriodUs(rgb));
+            std::this_thread::sleep_until(next);
+            if (!rgb->config.flags.refresh_on_demand)
+            {
+                ScanOutFrame(rgb);
+            }
+        }
+    }
+} // namespace
+
+static esp_err_t sim_rgb_reset(esp_lcd_panel_t *panel)
+{
+    return ESP_OK;
+}
+
+static esp_err_t sim_rgb_init(esp_lcd_panel_t *panel)
+{
+    SimRgbPanel *rgb = ToSim(panel);
+    if (!rgb->running.exchange(true))
+    {
+        rgb->scan_thread = std::thread(ScanThread, rgb);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t sim_rgb_del(esp_lcd_panel_t *panel)
+{
+    SimRgbPanel *rgb = ToSim(panel);
+    rgb->running = false;
+    if (rgb->scan_thread.joinable())
+    {
+        rgb->scan_thread.join();
+    }
+    for (int i = 0; i < rgb->num_fbs; i++)
+    {
+        heap_caps_free(rgb->fbs[i]);
+    }
+    SimRgbPanel *expected = rgb;
+    last_rgb_panel.compare_exchange_strong(expected, nullptr);
+    delete rgb;
+    return ESP_OK;
+}
+
+static esp_err_t sim_rgb_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    SimRgbPanel *rgb = ToSim(panel);
+    if (rgb->num_fbs == 0)
+    {
+        return ESP_OK;
+    }
+    // Passing one of the panel's own frame buffers switches scan-out to it on the next frame
+    for (int i = 0; i < rgb->num_fbs; i++)
+    {
+        if (color_data == rgb->fbs[i])
+        {
+            rgb->pending_fb = i;
+            return ESP_OK;
+        }
+    }
+
+    const int h_res = static_cast<int>(rgb->config.timings.h_res);
+    const int v_res = static_cast<int>(rgb->config.timings.v_res);
+    const size_t bpp = rgb->bytes_per_pixel;
+    const auto *src = static_cast<const uint8_t *>(color_data);
+    uint8_t *fb = rgb->fbs[rgb->cur_fb];
+    for (int y = y_start; y < y_end; y++)
+    {
+        for (int x = x_start; x < x_end; x++)
+        {
+            int dx = rgb->swap_xy ? y : x;
+            int dy = rgb->swap_xy ? x : y;
+            if (rgb->mirror_x)
+            {
+                dx = h_res - 1 - dx;
+            }
+            if (rgb->mirror_y)
+            {
+                dy = v_res - 1 - dy;
+            }
+            if (dx < 0 || dx >= h_res || dy < 0 || dy >= v_res)
+            {
+                src += bpp;
+                continue;
+            }
+            std::memcpy(fb + (static_cast<size_t>(dy) * h_res + dx) * bpp, src, bpp);
+            src += bpp;
+        }
+    }
+    if (rgb->callbacks.on_color_trans_done)
+    {
+        esp_lcd_rgb_panel_event_data_t edata = {};
+        rgb->callbacks.on_color_trans_done(panel, &edata, rgb->user_ctx);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t sim_rgb_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y)
+{
+    SimRgbPanel *rgb = ToSim(panel);
+    rgb->mirror_x = mirror_x;
+    rgb->mirror_y = mirror_y;
+    return ESP_OK;
+}
+
+static esp_err_t sim_rgb_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
+{
+    ToSim(panel)->swap_xy = swap_axes;
+    return ESP_OK;
+}
+
+static esp_err_t sim_rgb_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
+{
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_lcd_new_rgb_panel(const esp_lcd_rgb_panel_config_t *rgb_panel_config, esp_lcd_panel_handle_t *ret_panel)
+{
+    if (rgb_panel_config == nullptr || ret_panel == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int num_fbs = static_cast<int>(rgb_panel_config->num_fbs);
+    if (rgb_panel_config->flags.no_fb)
+    {
+        num_fbs = 0;
+    }
+    else if (num_fbs == 0)
+    {
+        num_fbs = rgb_panel_config->flags.double_fb ? 2 : 1;
+    }
+    if (num_fbs > kMaxFrameBuffers)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    auto *rgb = new SimRgbPanel{};
+    rgb->config = *rgb_panel_config;
+    rgb->bytes_per_pixel = (rgb_panel_config->bits_per_pixel ? rgb_panel_config->bits_per_pixel : rgb_panel_config->data_width) / 8;
+    rgb->fb_bytes = rgb_panel_config->timings.h_res * rgb_panel_config->timings.v_res * rgb->bytes_per_pixel;
+    rgb->num_fbs = num_fbs;
+    uint32_t caps = rgb_panel_config->flags.fb_in_psram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL;
+    for (int i = 0; i < num_fbs; i++)
+    {
+        rgb->fbs[i] = static_cast<uint8_t *>(heap_caps_aligned_calloc(64, 1, rgb->fb_bytes, caps));
+    }
+    rgb->cur_fb = 0;
+    rgb->pending_fb = -1;
+    rgb->pclk_hz = rgb_panel_config->timings.pclk_hz;
+    rgb->scanout.resize(rgb->fb_bytes);
+    rgb->bounce.resize((rgb_panel_config->bounce_buffer_size_px ? rgb_panel_config->bounce_buffer_size_px
+                                                                : rgb_panel_config->timings.h_res * rgb_panel_config->timings.v_res) *
+                       rgb->bytes_per_pixel);
+
+    rgb->base.reset = sim_rgb_reset;
+    rgb->base.init = sim_rgb_init;
+    rgb->base.del = sim_rgb_del;
+    rgb->base.draw_bitmap = sim_rgb_draw_bitmap;
+    rgb->base.mirror = sim_rgb_mirror;
+    rgb->base.swap_xy = sim_rgb_swap_xy;
+    rgb->base.disp_on_off = sim_rgb_disp_on_off;
+
+    last_rgb_panel = rgb;
+    *ret_panel = &rgb->base;
+    ESP_LOGI(TAG, "RGB panel %ux%u, %d frame buffer(s), bounce buffer %zu px",
+             rgb_panel_config->timings.h_res, rgb_panel_config->timings.v_res, num_fbs,
+             static_cast<size_t>(rgb_panel_config->bounce_buffer_size_px));
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_lcd_rgb_panel_register_event_callbacks(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_callbacks_t *callbacks, void *user_ctx)
+{
+    if (panel == nullptr || callbacks == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    SimRgbPanel *rgb = ToSim(panel);
+    std::lock_guard<std::mutex> lock(rgb->scanout_mutex);
+    rgb->callbacks = *callbacks;
+    rgb->user_ctx = user_ctx;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_lcd_rgb_panel_set_pclk(esp_lcd_panel_handle_t panel, uint32_t freq_hz)
+{
+    if (panel == nullptr || freq_hz == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ToSim(panel)->pclk_hz = freq_hz;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_lcd_rgb_panel_restart(esp_lcd_panel_handle_t panel)
+{
+    return panel ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+extern "C" esp_err_t esp_lcd_rgb_panel_get_frame_buffer(esp_lcd_panel_handle_t panel, uint32_t fb_num, void **fb0, ...)
+{
+    if (panel == nullptr || fb0 == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    SimRgbPanel *rgb = ToSim(panel);
+    if (fb_num > static_cast<uint32_t>(rgb->num_fbs))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *fb0 = rgb->fbs[0];
+    va_list args;
+    va_start(args, fb0);
+    for (uint32_t i = 1; i < fb_num; i++)
+    {
+        void **fb = va_arg(args, void **);
+        *fb = rgb->fbs[i];
+    }
+    va_end(args);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_lcd_rgb_panel_refresh(esp_lcd_panel_handle_t panel)
+{
+    if (panel == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ScanOutFrame(ToSim(panel));
+    return ESP_OK;
+}
+
+// Simulator helpers
+
+extern "C" esp_lcd_panel_handle_t sim_lcd_get_rgb_panel(void)
+{
+    SimRgbPanel *rgb = last_rgb_panel.load();
+    return rgb ? &rgb->base : nullptr;
+}
+
+extern "C" uint32_t sim_lcd_get_frame_count(esp_lcd_panel_handle_t panel)
+{
+    return panel ? ToSim(panel)->frame_count.load() : 0;
+}
+
+extern "C" esp_err_t sim_lcd_dump_ppm(esp_lcd_panel_handle_t panel, const char *path)
+{
+    if (panel == nullptr || path == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    SimRgbPanel *rgb = ToSim(panel);
+    if (rgb->bytes_per_pixel != 2)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    FILE *file = std::fopen(path, "wb");
+    if (file == nullptr)
+    {
+        return ESP_FAIL;
+    }
+    const uint32_t width = rgb->config.timings.h_res;
+    const uint32_t height = rgb->config.timings.v_res;
+    std::fprintf(file, "P6\n%u %u\n255\n", width, height);
+    std::vector<uint8_t> row(width * 3);
+    std::lock_guard<std::mutex> lock(rgb->scanout_mutex);
+    const auto *pixels = reinterpret_cast<const uint16_t *>(rgb->scanout.data());
+    for (uint32_t y = 0; y < height; y++)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            uint16_t c = pixels[y * width + x];
+            uint8_t r = (c >> 11) & 0x1F;
+            uint8_t g = (c >> 5) & 0x3F;
+            uint8_t b = c & 0x1F;
+            row[x * 3 + 0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+            row[x * 3 + 1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+            row[x * 3 + 2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+        }
+        std::fwrite(row.data(), 1, row.size(), file);
+    }
+    std::fclose(file);
+    return ESP_OK;
+}
@@ -0,0 +1,189 @@
+// Host stand-in for esp_timer. A single dispatcher thread runs every callback,
+// which matches ESP_TIMER_TASK dispatch: callbacks never run concurrently.
+
+#include <esp_timer.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+struct esp_timer
+{
+    esp_timer_create_args_t args;
+    int64_t period_us = 0;
+    int64_t deadline_us = 0;
+    bool active = false;
+};
+
+namespace
+{
+    class TimerService
+    {
+    public:
+        static TimerService &GetInstance()
+        {
+            static TimerService instance;
+            return instance;
+        }
+
+        void Start(esp_timer *timer, int64_t timeout_us, int64_t period_us)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Remove(timer);
+            timer->period_us = period_us;
+            timer->deadline_us = esp_timer_get_time() + timeout_us;
+            timer->active = true;
+            queue_.emplace(timer->deadline_us, timer);
+            cv_.notify_all();
+        }
+
+        bool Stop(esp_timer *timer)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bool was_active = timer->active;
+            Remove(timer);
+            return was_active;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::multimap<int64_t, esp_timer *> queue_;
+
+        TimerService()
+        {
+            std::thread([this]()
+                        { Run(); })
+                .detach();
+        }
+
+        void Remove(esp_timer *timer)
+        {
+            timer->active = false;
+            for (auto it = queue_.begin(); it != queue_.end(); ++it)
+            {
+                if (it->second == timer)
+                {
+                    queue_.erase(it);
+                    break;
+                }
+            }
+        }
+
+        void Run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;)
+            {
+                if (queue_.empty())
+                {
+                    cv_.wait(lock);
+                    continue;
+                }
+                auto it = queue_.begin();
+                int64_t now = esp_timer_get_time();
+                if (it->first > now)
+                {
+                    cv_.wait_for(lock, std::chrono::microseconds(it->first - now));
+                    continue;
+                }
+                esp_timer *timer = it->second;
+                queue_.erase(it);
+                if (timer->period_us > 0)
+                {
+                    timer->deadline_us += timer->period_us;
+                    if (timer->args.skip_unhandled_events && timer->deadline_us < now)
+                    {
+                        timer->deadline_us = now + timer->period_us;
+                    }
+                    queue_.emplace(timer->deadline_us, timer);
+                }
+                else
+                {
+                    timer->active = false;
+                }
+                auto callback = timer->args.callback;
+                void *arg = timer->args.arg;
+                lock.unlock();
+                callback(arg);
+                lock.lock();
+            }
+        }
+    };
+} // namespace
+
+extern "C" esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (create_args == nullptr || create_args->callback == nullptr || out_handle == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto *timer = new esp_timer;
+    timer->args = *create_args;
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->active)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    TimerService::GetInstance().Start(timer, static_cast<int64_t>(timeout_us), 0);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    if (timer == nullptr || period == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->active)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    TimerService::GetInstance().Start(timer, static_cast<int64_t>(period), static_cast<int64_t>(period));
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return TimerService::GetInstance().Stop(timer) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+extern "C" esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (timer == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->active)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    delete timer;
+    return ESP_OK;
+}
+
+extern "C" bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    return timer != nullptr && timer->active;
+}
+
+extern "C" int64_t esp_timer_get_time(void)
+{
+    static const auto boot = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - boot).count();
+}
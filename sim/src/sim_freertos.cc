@@ -0,0 +1,348 @@
+// Host stand-in for the FreeRTOS task, notification and semaphore APIs.
+//
+// Every task is a detached std::thread. Task notifications and semaphores are
+// built on a mutex/condition-variable pair, which is enough to reproduce the
+// blocking behaviour the firmware relies on (e.g. waiting for VSYNC).
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <freertos/timers.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct sim_task
+{
+    std::string name;
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t notify_value = 0;
+    BaseType_t core_id = 0;
+};
+
+static thread_local sim_task *current_task = nullptr;
+
+static std::chrono::steady_clock::time_point BootTime()
+{
+    static const auto boot = std::chrono::steady_clock::now();
+    return boot;
+}
+
+static sim_task *CurrentTask()
+{
+    if (current_task == nullptr)
+    {
+        // Threads not created through xTaskCreate (e.g. the simulator's main
+        // thread) get a task record on first use
+        current_task = new sim_task;
+        current_task->name = "main";
+    }
+    return current_task;
+}
+
+extern "C" BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task_code, const char *name, uint32_t stack_depth, void *parameters,
+                                              UBaseType_t priority, TaskHandle_t *created_task, BaseType_t core_id)
+{
+    auto *task = new sim_task;
+    task->name = name ? name : "";
+    task->core_id = (core_id == tskNO_AFFINITY) ? 0 : core_id;
+    if (created_task)
+    {
+        *created_task = task;
+    }
+    std::thread([task, task_code, parameters]()
+                {
+                    current_task = task;
+                    task_code(parameters);
+                })
+        .detach();
+    return pdPASS;
+}
+
+extern "C" BaseType_t xTaskCreate(TaskFunction_t task_code, const char *name, uint32_t stack_depth, void *parameters,
+                                  UBaseType_t priority, TaskHandle_t *created_task)
+{
+    return xTaskCreatePinnedToCore(task_code, name, stack_depth, parameters, priority, created_task, tskNO_AFFINITY);
+}
+
+extern "C" void vTaskDelete(TaskHandle_t task)
+{
+    if (task == nullptr || task == current_task)
+    {
+        // A task deleting itself never returns; park the thread forever
+        for (;;)
+        {
+            std::this_thread::sleep_for(std::chrono::hours(1));
+        }
+    }
+}
+
+extern "C" void vTaskDelay(TickType_t ticks)
+{
+    if (ticks == 0)
+    {
+        std::this_thread::yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(pdTICKS_TO_MS(ticks)));
+}
+
+extern "C" TickType_t xTaskGetTickCount(void)
+{
+    auto elapsed = std::chrono::steady_clock::now() - BootTime();
+    return static_cast<TickType_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+extern "C" TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+extern "C" TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return CurrentTask();
+}
+
+extern "C" BaseType_t xPortGetCoreID(void)
+{
+    return CurrentTask()->core_id;
+}
+
+// Task notifications
+
+extern "C" uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait)
+{
+    sim_task *task = CurrentTask();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    auto ready = [task]()
+    { return task->notify_value != 0; };
+    if (ticks_to_wait == portMAX_DELAY)
+    {
+        task->cv.wait(lock, ready);
+    }
+    else
+    {
+        task->cv.wait_for(lock, std::chrono::milliseconds(pdTICKS_TO_MS(ticks_to_wait)), ready);
+    }
+    uint32_t value = task->notify_value;
+    if (value != 0)
+    {
+        task->notify_value = clear_count_on_exit ? 0 : value - 1;
+    }
+    return value;
+}
+
+extern "C" BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    if (task == nullptr)
+    {
+        return pdFAIL;
+    }
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->notify_value++;
+    }
+    task->cv.notify_all();
+    return pdPASS;
+}
+
+extern "C" void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    xTaskNotifyGive(task);
+    if (higher_priority_task_woken)
+    {
+        *higher_priority_task_woken = pdFALSE;
+    }
+}
+
+extern "C" uint32_t ulTaskNotifyValueClear(TaskHandle_t task, uint32_t bits_to_clear)
+{
+    if (task == nullptr)
+    {
+        task = CurrentTask();
+    }
+    std::lock_guard<std::mutex> lock(task->mutex);
+    uint32_t value = task->notify_value;
+    task->notify_value &= ~bits_to_clear;
+    return value;
+}
+
+// Semaphores and mutexes
+
+struct sim_semaphore
+{
+    enum class Kind
+    {
+        kMutex,
+        kRecursiveMutex,
+        kCounting,
+    } kind;
+    std::mutex mutex;
+    std::condition_variable cv;
+    UBaseType_t count = 0;
+    UBaseType_t max_count = 1;
+    sim_task *owner = nullptr;
+    UBaseType_t recursion = 0;
+};
+
+static SemaphoreHandle_t CreateSemaphore(sim_semaphore::Kind kind, UBaseType_t max_count, UBaseType_t initial_count)
+{
+    auto *sem = new sim_semaphore;
+    sem->kind = kind;
+    sem->max_count = max_count;
+    sem->count = initial_count;
+    return sem;
+}
+
+extern "C" SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return CreateSemaphore(sim_semaphore::Kind::kMutex, 1, 1);
+}
+
+extern "C" SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return CreateSemaphore(sim_semaphore::Kind::kRecursiveMutex, 1, 1);
+}
+
+extern "C" SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return CreateSemaphore(sim_semaphore::Kind::kCounting, 1, 0);
+}
+
+extern "C" SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    return CreateSemaphore(sim_semaphore::Kind::kCounting, max_count, initial_count);
+}
+
+extern "C" BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks_to_wait)
+{
+    if (sem == nullptr)
+    {
+        return pdFALSE;
+    }
+    sim_task *task = CurrentTask();
+    std::unique_lock<std::mutex> lock(sem->mutex);
+    if (sem->kind == sim_semaphore::Kind::kRecursiveMutex && sem->owner == task)
+    {
+        sem->recursion++;
+        return pdTRUE;
+    }
+    auto ready = [sem]()
+    { return sem->count > 0; };
+    if (ticks_to_wait == portMAX_DELAY)
+    {
+        sem->cv.wait(lock, ready);
+    }
+    else if (!sem->cv.wait_for(lock, std::chrono::milliseconds(pdTICKS_TO_MS(ticks_to_wait)), ready))
+    {
+        return pdFALSE;
+    }
+    sem->count--;
+    if (sem->kind != sim_semaphore::Kind::kCounting)
+    {
+        sem->owner = task;
+        sem->recursion = 1;
+    }
+    return pdTRUE;
+}
+
+extern "C" BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    if (sem == nullptr)
+    {
+        return pdFALSE;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sem->mutex);
+        if (sem->kind == sim_semaphore::Kind::kRecursiveMutex && --sem->recursion > 0)
+        {
+            return pdTRUE;
+        }
+        if (sem->count >= sem->max_count)
+        {
+            return pdFALSE;
+        }
+        sem->owner = nullptr;
+        sem->count++;
+    }
+    sem->cv.notify_one();
+    return pdTRUE;
+}
+
+extern "C" BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks_to_wait)
+{
+    return xSemaphoreTake(sem, ticks_to_wait);
+}
+
+extern "C" BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem)
+{
+    return xSemaphoreGive(sem);
+}
+
+extern "C" BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *higher_priority_task_woken)
+{
+    if (higher_priority_task_woken)
+    {
+        *higher_priority_task_woken = pdFALSE;
+    }
+    return xSemaphoreGive(sem);
+}
+
+extern "C" void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    delete sem;
+}
+
+// Deferred calls: each runs on its own short-lived thread standing in for the timer task
+
+extern "C" BaseType_t xTimerPendFunctionCall(PendedFunction_t function_to_pend, void *parameter1, uint32_t parameter2,
+                                             TickType_t ticks_to_wait)
+{
+    std::thread([=]
+                { function_to_pend(parameter1, parameter2); })
+        .detach();
+    return pdPASS;
+}
+
+extern "C" BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t function_to_pend, void *parameter1, uint32_t parameter2,
+                                                    BaseType_t *higher_priority_task_woken)
+{
+    if (higher_priority_task_woken)
+    {
+        *higher_priority_task_woken = pdFALSE;
+    }
+    return xTimerPendFunctionCall(function_to_pend, parameter1, parameter2, 0);
+}
+
+// Critical sections: a spinlock shared by all "cores"
+
+extern "C" void sim_port_enter_critical(portMUX_TYPE *mux)
+{
+    int self = static_cast<int>(reinterpret_cast<uintptr_t>(CurrentTask()) & 0x7FFFFFFF) | 1;
+    if (__atomic_load_n(&mux->owner, __ATOMIC_ACQUIRE) == self)
+    {
+        mux->count = mux->count + 1;
+        return;
+    }
+    int expected = 0;
+    while (!__atomic_compare_exchange_n(&mux->owner, &expected, self, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        expected = 0;
+        std::this_thread::yield();
+    }
+    mux->count = 1;
+}
+
+extern "C" void sim_port_exit_critical(portMUX_TYPE *mux)
+{
+    mux->count = mux->count - 1;
+    if (mux->count == 0)
+    {
+        __atomic_store_n(&mux->owner, 0, __ATOMIC_RELEASE);
+    }
+}
@@ -0,0 +1,171 @@
+// Host stand-in for the LEDC PWM driver. Duty changes are latched on
+// ledc_update_duty() just like the hardware and can be read back. A fade is
+// a thread stepping the duty once per millisecond, stopping it bumps the
+// channel's fade generation.
+
+#include <driver/ledc.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    struct SimLedcChannel
+    {
+        std::atomic<uint32_t> pending_duty{0};
+        std::atomic<uint32_t> duty{0};
+        bool configured = false;
+        std::atomic<uint32_t> fade_generation{0};
+        ledc_cb_t fade_cb = nullptr;
+        void *fade_cb_arg = nullptr;
+    };
+
+    SimLedcChannel channels[LEDC_CHANNEL_MAX];
+    ledc_timer_bit_t timer_resolution[LEDC_TIMER_MAX];
+} // namespace
+
+extern "C" esp_err_t ledc_timer_config(const ledc_timer_config_t *timer_conf)
+{
+    if (timer_conf == nullptr || timer_conf->timer_num >= LEDC_TIMER_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    timer_resolution[timer_conf->timer_num] = timer_conf->duty_resolution;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t ledc_channel_config(const ledc_channel_config_t *ledc_conf)
+{
+    if (ledc_conf == nullptr || ledc_conf->channel >= LEDC_CHANNEL_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto &channel = channels[ledc_conf->channel];
+    channel.configured = true;
+    channel.pending_duty = ledc_conf->duty;
+    channel.duty = ledc_conf->duty;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty)
+{
+    if (channel >= LEDC_CHANNEL_MAX || !channels[channel].configured)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    channels[channel].pending_duty = duty;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    if (channel >= LEDC_CHANNEL_MAX || !channels[channel].configured)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    channels[channel].duty = channels[channel].pending_duty.load();
+    return ESP_OK;
+}
+
+extern "C" uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    if (channel >= LEDC_CHANNEL_MAX)
+    {
+        return 0;
+    }
+    return channels[channel].duty;
+}
+
+extern "C" esp_err_t ledc_set_duty_and_update(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty,
+                                              uint32_t hpoint)
+{
+    esp_err_t ret = ledc_set_duty(speed_mode, channel, duty);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    return ledc_update_duty(speed_mode, channel);
+}
+
+extern "C" esp_err_t ledc_fade_func_install(int intr_alloc_flags)
+{
+    return ESP_OK;
+}
+
+extern "C" void ledc_fade_func_uninstall(void)
+{
+}
+
+extern "C" esp_err_t ledc_cb_register(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_cbs_t *cbs, void *user_arg)
+{
+    if (channel >= LEDC_CHANNEL_MAX || cbs == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    channels[channel].fade_cb = cbs->fade_cb;
+    channels[channel].fade_cb_arg = user_arg;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t ledc_set_fade_time_and_start(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty,
+                                                  uint32_t max_fade_time_ms, ledc_fade_mode_t fade_mode)
+{
+    if (channel >= LEDC_CHANNEL_MAX || !channels[channel].configured)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    auto &ch = channels[channel];
+    uint32_t generation = ++ch.fade_generation;
+    uint32_t start_duty = ch.duty;
+    std::thread fade([&ch, channel, speed_mode, generation, start_duty, target_duty, max_fade_time_ms]
+                     {
+                         for (uint32_t ms = 1; ms <= max_fade_time_ms; ms++)
+                         {
+                             std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                             if (ch.fade_generation != generation)
+                             {
+                                 return;
+                             }
+                             int64_t delta = static_cast<int64_t>(target_duty) - start_duty;
+                             ch.duty = start_duty + delta * ms / max_fade_time_ms;
+                         }
+                         ch.duty = target_duty;
+                         ch.pending_duty = target_duty;
+                         if (ch.fade_cb)
+                         {
+                             ledc_cb_param_t param = {LEDC_FADE_END_EVT, static_cast<uint32_t>(speed_mode),
+                                                      static_cast<uint32_t>(channel), target_duty};
+                             ch.fade_cb(&param, ch.fade_cb_arg);
+                         } });
+    if (fade_mode == LEDC_FADE_WAIT_DONE)
+    {
+        fade.join();
+    }
+    else
+    {
+        fade.detach();
+    }
+    return ESP_OK;
+}
+
+extern "C" esp_err_t ledc_fade_stop(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    if (channel >= LEDC_CHANNEL_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    channels[channel].fade_generation++;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t ledc_stop(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t idle_level)
+{
+    if (channel >= LEDC_CHANNEL_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    channels[channel].duty = 0;
+    channels[channel].configured = false;
+    return ESP_OK;
+}
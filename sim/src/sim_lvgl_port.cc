@@ -0,0 +1,239 @@
+// Host stand-in for espressif/esp_lvgl_port 2.x.
+//
+// lvgl_port_init() starts the LVGL task and an esp_timer driving lv_tick_inc(),
+// exactly like the component. lvgl_port_add_disp_rgb() follows the component's
+// RGB path: direct/full-refresh displays render straight into the panel frame
+// buffers and swap them on the last flush, optionally waiting for the next
+// VSYNC (bounce-frame-finish in bounce-buffer mode) to avoid tearing.
+
+#include <esp_lvgl_port.h>
+#include <esp_lcd_panel_ops.h>
+#include <esp_lcd_panel_rgb.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+#include <algorithm>
+
+#define TAG "sim_lvgl_port"
+
+namespace
+{
+    struct SimPortDisplay
+    {
+        esp_lcd_panel_handle_t panel;
+        uint32_t hres;
+        uint32_t vres;
+        bool direct_mode;
+        bool full_refresh;
+        bool avoid_tearing;
+        void *draw_buffs[2];
+        bool own_buffers;
+    };
+
+    SemaphoreHandle_t port_mutex = nullptr;
+    TaskHandle_t port_task = nullptr;
+    esp_timer_handle_t tick_timer = nullptr;
+    lvgl_port_cfg_t port_cfg;
+
+    void PortTask(void *arg)
+    {
+        ESP_LOGI(TAG, "Starting LVGL task");
+        for (;;)
+        {
+            uint32_t sleep_ms = 0;
+            if (lvgl_port_lock(0))
+            {
+                sleep_ms = lv_timer_handler();
+                lvgl_port_unlock();
+            }
+            sleep_ms = std::clamp<uint32_t>(sleep_ms, 1, static_cast<uint32_t>(port_cfg.task_max_sleep_ms));
+            vTaskDelay(pdMS_TO_TICKS(sleep_ms));
+        }
+    }
+
+    bool OnVsync(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx)
+    {
+        BaseType_t need_yield = pdFALSE;
+        if (port_task != nullptr)
+        {
+            vTaskNotifyGiveFromISR(port_task, &need_yield);
+        }
+        return need_yield == pdTRUE;
+    }
+
+    void FlushCallback(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+    {
+        auto *ctx = static_cast<SimPortDisplay *>(lv_display_get_user_data(disp));
+        if (ctx->direct_mode || ctx->full_refresh)
+        {
+            if (lv_display_flush_is_last(disp))
+            {
+                // Hand the whole frame buffer to the panel; it switches on the next frame
+                esp_lcd_panel_draw_bitmap(ctx->panel, 0, 0, ctx->hres, ctx->vres, px_map);
+                if (ctx->avoid_tearing)
+                {
+                    ulTaskNotifyValueClear(nullptr, UINT32_MAX);
+                    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                }
+            }
+        }
+        else
+        {
+            esp_lcd_panel_draw_bitmap(ctx->panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map);
+        }
+        lv_display_flush_ready(disp);
+    }
+} // namespace
+
+extern "C" esp_err_t lvgl_port_init(const lvgl_port_cfg_t *cfg)
+{
+    if (cfg == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (port_mutex != nullptr)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    port_cfg = *cfg;
+    port_mutex = xSemaphoreCreateRecursiveMutex();
+
+    const esp_timer_create_args_t tick_args = {
+        .callback = [](void *arg)
+        { lv_tick_inc(port_cfg.timer_period_ms); },
+        .arg = nullptr,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "LVGL tick",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&tick_args, &tick_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(tick_timer, port_cfg.timer_period_ms * 1000));
+
+    xTaskCreatePinnedToCore(PortTask, "taskLVGL", port_cfg.task_stack, nullptr, port_cfg.task_priority, &port_task,
+                            port_cfg.task_affinity < 0 ? tskNO_AFFINITY : port_cfg.task_affinity);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t lvgl_port_deinit(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+extern "C" bool lvgl_port_lock(uint32_t timeout_ms)
+{
+    if (port_mutex == nullptr)
+    {
+        return false;
+    }
+    const TickType_t ticks = timeout_ms == 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return xSemaphoreTakeRecursive(port_mutex, ticks) == pdTRUE;
+}
+
+extern "C" void lvgl_port_unlock(void)
+{
+    if (port_mutex != nullptr)
+    {
+        xSemaphoreGiveRecursive(port_mutex);
+    }
+}
+
+extern "C" lv_display_t *lvgl_port_add_disp_rgb(const lvgl_port_display_cfg_t *disp_cfg, const lvgl_port_display_rgb_cfg_t *rgb_cfg)
+{
+    if (disp_cfg == nullptr || rgb_cfg == nullptr || disp_cfg->panel_handle == nullptr)
+    {
+        return nullptr;
+    }
+    lvgl_port_lock(0);
+
+    auto *ctx = new SimPortDisplay{};
+    ctx->panel = disp_cfg->panel_handle;
+    ctx->hres = disp_cfg->hres;
+    ctx->vres = disp_cfg->vres;
+    ctx->direct_mode = disp_cfg->flags.direct_mode;
+    ctx->full_refresh = disp_cfg->flags.full_refresh;
+    ctx->avoid_tearing = rgb_cfg->flags.avoid_tearing;
+
+    uint32_t buffer_bytes = 0;
+    if (ctx->direct_mode || ctx->full_refresh)
+    {
+        buffer_bytes = disp_cfg->hres * disp_cfg->vres * sizeof(uint16_t);
+        if (ctx->avoid_tearing)
+        {
+            ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(ctx->panel, 2, &ctx->draw_buffs[0], &ctx->draw_buffs[1]));
+        }
+        else
+        {
+            ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(ctx->panel, 1, &ctx->draw_buffs[0]));
+        }
+    }
+    else
+    {
+        buffer_bytes = disp_cfg->buffer_size * sizeof(uint16_t);
+        uint32_t caps = disp_cfg->flags.buff_spiram ? MALLOC_CAP_SPIRAM : (MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+        ctx->draw_buffs[0] = heap_caps_malloc(buffer_bytes, caps);
+        if (disp_cfg->double_buffer)
+        {
+            ctx->draw_buffs[1] = heap_caps_malloc(buffer_bytes, caps);
+        }
+        ctx->own_buffers = true;
+    }
+
+    lv_display_t *disp = lv_display_create(disp_cfg->hres, disp_cfg->vres);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_render_mode_t render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL;
+    if (ctx->full_refresh)
+    {
+        render_mode = LV_DISPLAY_RENDER_MODE_FULL;
+    }
+    else if (ctx->direct_mode)
+    {
+        render_mode = LV_DISPLAY_RENDER_MODE_DIRECT;
+    }
+    lv_display_set_buffers(disp, ctx->draw_buffs[0], ctx->draw_buffs[1], buffer_bytes, render_mode);
+    lv_display_set_flush_cb(disp, FlushCallback);
+    lv_display_set_user_data(disp, ctx);
+
+    if (ctx->avoid_tearing)
+    {
+        esp_lcd_rgb_panel_event_callbacks_t cbs = {};
+        if (rgb_cfg->flags.bb_mode)
+        {
+            cbs.on_bounce_frame_finish = OnVsync;
+        }
+        else
+        {
+            cbs.on_vsync = OnVsync;
+        }
+        ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(ctx->panel, &cbs, ctx));
+    }
+
+    // Rotation is applied through the panel, as the component does for non-sw_rotate displays
+    esp_lcd_panel_swap_xy(ctx->panel, disp_cfg->rotation.swap_xy);
+    esp_lcd_panel_mirror(ctx->panel, disp_cfg->rotation.mirror_x, disp_cfg->rotation.mirror_y);
+
+    lvgl_port_unlock();
+    return disp;
+}
+
+extern "C" esp_err_t lvgl_port_remove_disp(lv_display_t *disp)
+{
+    if (disp == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    lvgl_port_lock(0);
+    auto *ctx = static_cast<SimPortDisplay *>(lv_display_get_user_data(disp));
+    lv_display_delete(disp);
+    if (ctx->own_buffers)
+    {
+        heap_caps_free(ctx->draw_buffs[0]);
+        heap_caps_free(ctx->draw_buffs[1]);
+    }
+    delete ctx;
+    lvgl_port_unlock();
+    return ESP_OK;
+}
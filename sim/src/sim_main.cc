@@ -0,0 +1,86 @@
+// Host entry point for the simulator.
+//
+// Runs the firmware's app_main() in its own task, lets it execute for a fixed
+// amount of wall-clock time and then writes the frame being scanned out by the
+// RGB panel to a PPM file. The process exits afterwards, so the binary can be
+// driven from perf, valgrind --tool=cachegrind or a CI job.
+//
+// Usage: yuying_sim [--run-ms N] [--dump path.ppm] [--partition label=file ...]
+
+#include <esp_log.h>
+#include <esp_lvgl_port.h>
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <sim_lcd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#define TAG "sim"
+
+extern "C" void app_main(void);
+
+int main(int argc, char **argv)
+{
+    int run_ms = 5000;
+    const char *dump_path = "yuying_sim.ppm";
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--run-ms") == 0 && i + 1 < argc)
+        {
+            run_ms = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--dump") == 0 && i + 1 < argc)
+        {
+            dump_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--partition") == 0 && i + 1 < argc)
+        {
+            std::string spec = argv[++i];
+            size_t eq = spec.find('=');
+            if (eq == std::string::npos ||
+                sim_partition_register(spec.substr(0, eq).c_str(), spec.substr(eq + 1).c_str()) != ESP_OK)
+            {
+                std::fprintf(stderr, "Bad --partition %s, expected label=file\n", spec.c_str());
+                return 2;
+            }
+        }
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--run-ms N] [--dump path.ppm] [--partition label=file ...]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    xTaskCreatePinnedToCore([](void *)
+                            { app_main(); },
+                            "main", 16384, nullptr, 1, nullptr, 0);
+
+    vTaskDelay(pdMS_TO_TICKS(run_ms));
+
+    esp_lcd_panel_handle_t panel = sim_lcd_get_rgb_panel();
+    if (panel == nullptr)
+    {
+        ESP_LOGE(TAG, "No RGB panel was created");
+        return 1;
+    }
+
+    // Hold the LVGL lock so the dump is not taken halfway through a render
+    lvgl_port_lock(0);
+    esp_err_t ret = sim_lcd_dump_ppm(panel, dump_path);
+    uint32_t frames = sim_lcd_get_frame_count(panel);
+    lvgl_port_unlock();
+
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to write %s", dump_path);
+        return 1;
+    }
+    ESP_LOGI(TAG, "Scanned out %u frames in %d ms, last frame written to %s", frames, run_ms, dump_path);
+    std::fflush(stdout);
+    // Firmware tasks never return; leave without running static destructors under them
+    std::_Exit(0);
+}
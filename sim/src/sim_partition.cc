@@ -0,0 +1,123 @@
+// Flash partitions backed by host files, loaded whole on registration
+
+#include <esp_partition.h>
+#include <esp_log.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define TAG "sim_partition"
+
+namespace
+{
+    struct SimPartition
+    {
+        esp_partition_t info;
+        std::vector<uint8_t> data;
+    };
+
+    std::mutex partitions_mutex;
+    std::vector<std::unique_ptr<SimPartition>> partitions;
+    uint32_t next_address = 0x200000;
+
+    SimPartition *FindPartition(const esp_partition_t *partition)
+    {
+        for (auto &p : partitions)
+        {
+            if (&p->info == partition)
+            {
+                return p.get();
+            }
+        }
+        return nullptr;
+    }
+}
+
+extern "C" esp_err_t sim_partition_register(const char *label, const char *path)
+{
+    FILE *file = std::fopen(path, "rb");
+    if (file == nullptr)
+    {
+        ESP_LOGE(TAG, "Cannot open %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    auto partition = std::make_unique<SimPartition>();
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        partition->data.insert(partition->data.end(), chunk, chunk + n);
+    }
+    std::fclose(file);
+
+    // Round up like a real partition, erased flash reads as 0xff
+    size_t size = (partition->data.size() + 0xfff) & ~static_cast<size_t>(0xfff);
+    partition->data.resize(size, 0xff);
+
+    std::lock_guard<std::mutex> lock(partitions_mutex);
+    partition->info.type = ESP_PARTITION_TYPE_DATA;
+    partition->info.subtype = ESP_PARTITION_SUBTYPE_ANY;
+    partition->info.address = next_address;
+    partition->info.size = static_cast<uint32_t>(size);
+    partition->info.erase_size = 0x1000;
+    std::strncpy(partition->info.label, label, sizeof(partition->info.label) - 1);
+    partition->info.readonly = true;
+    next_address += partition->info.size;
+    ESP_LOGI(TAG, "Partition '%s' at 0x%x: %s (%u bytes)", label, (unsigned)partition->info.address, path,
+             (unsigned)size);
+    partitions.push_back(std::move(partition));
+    return ESP_OK;
+}
+
+extern "C" const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                           const char *label)
+{
+    std::lock_guard<std::mutex> lock(partitions_mutex);
+    for (auto &p : partitions)
+    {
+        if (type != ESP_PARTITION_TYPE_ANY && p->info.type != type)
+        {
+            continue;
+        }
+        if (label != nullptr && std::strcmp(label, p->info.label) != 0)
+        {
+            continue;
+        }
+        return &p->info;
+    }
+    return nullptr;
+}
+
+extern "C" esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    std::lock_guard<std::mutex> lock(partitions_mutex);
+    SimPartition *p = FindPartition(partition);
+    if (p == nullptr || src_offset + size > p->data.size())
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::memcpy(dst, p->data.data() + src_offset, size);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                                        esp_partition_mmap_memory_t memory, const void **out_ptr,
+                                        esp_partition_mmap_handle_t *out_handle)
+{
+    std::lock_guard<std::mutex> lock(partitions_mutex);
+    SimPartition *p = FindPartition(partition);
+    if (p == nullptr || offset + size > p->data.size())
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_ptr = p->data.data() + offset;
+    *out_handle = 0;
+    return ESP_OK;
+}
+
+extern "C" void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+}
@@ -0,0 +1,282 @@
+// Host stand-ins for the small ESP-IDF services used by the firmware:
+// logging, error names, NVS, the default event loop, GPIO, power
+// management locks and capability-based heap allocation.
+
+#include <esp_err.h>
+#include <esp_log.h>
+#include <esp_event.h>
+#include <esp_heap_caps.h>
+#include <esp_pm.h>
+#include <esp_timer.h>
+#include <nvs_flash.h>
+#include <nvs.h>
+#include <driver/gpio.h>
+
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+extern "C" const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code)
+    {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_FAIL:
+        return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+        return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+        return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:
+        return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:
+        return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:
+        return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:
+        return "ESP_ERR_TIMEOUT";
+    default:
+        return "UNKNOWN ERROR";
+    }
+}
+
+// Logging
+
+static std::mutex log_mutex;
+
+extern "C" uint32_t esp_log_timestamp(void)
+{
+    return static_cast<uint32_t>(esp_timer_get_time() / 1000);
+}
+
+extern "C" void esp_log_write_str(char level, const char *tag, const char *format, ...)
+{
+    std::lock_guard<std::mutex> lock(log_mutex);
+    std::printf("%c (%u) %s: ", level, esp_log_timestamp(), tag);
+    va_list args;
+    va_start(args, format);
+    std::vprintf(format, args);
+    va_end(args);
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+// Event loop and NVS have no observable behaviour in the simulator
+
+extern "C" esp_err_t esp_event_loop_create_default(void)
+{
+    return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_flash_erase(void)
+{
+    return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (namespace_name == nullptr || out_handle == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+extern "C" void nvs_close(nvs_handle_t handle)
+{
+}
+
+// GPIO
+
+static std::atomic<uint32_t> gpio_levels[GPIO_NUM_MAX];
+
+extern "C" esp_err_t gpio_config(const gpio_config_t *config)
+{
+    return config ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+extern "C" esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    gpio_levels[gpio_num] = level;
+    return ESP_OK;
+}
+
+extern "C" int gpio_get_level(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+    {
+        return 0;
+    }
+    return static_cast<int>(gpio_levels[gpio_num].load());
+}
+
+extern "C" esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    return gpio_set_level(gpio_num, 0);
+}
+
+// Power management locks only keep a reference count
+
+struct esp_pm_lock
+{
+    esp_pm_lock_type_t type;
+    const char *name;
+    std::atomic<int> count;
+};
+
+extern "C" esp_err_t esp_pm_lock_create(esp_pm_lock_type_t lock_type, int arg, const char *name, esp_pm_lock_handle_t *out_handle)
+{
+    if (out_handle == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto *lock = new esp_pm_lock;
+    lock->type = lock_type;
+    lock->name = name;
+    lock->count = 0;
+    *out_handle = lock;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t handle)
+{
+    if (handle == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    handle->count++;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t handle)
+{
+    if (handle == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->count.fetch_sub(1) <= 0)
+    {
+        handle->count++;
+        return ESP_ERR_INVALID_STATE;
+    }
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_pm_lock_delete(esp_pm_lock_handle_t handle)
+{
+    if (handle == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->count != 0)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    delete handle;
+    return ESP_OK;
+}
+
+// Heap: allocations are tracked per memory type so that heap_caps_get_free_size()
+// reports the same deltas the device would (8 MB octal PSRAM, ~320 KB internal).
+
+static constexpr size_t kSimPsramBytes = 8 * 1024 * 1024;
+static constexpr size_t kSimInternalBytes = 320 * 1024;
+
+static std::atomic<size_t> psram_used{0};
+static std::atomic<size_t> internal_used{0};
+
+struct HeapHeader
+{
+    size_t size;
+    uint32_t caps;
+    void *base;
+};
+
+static std::atomic<size_t> &UsedCounter(uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? psram_used : internal_used;
+}
+
+extern "C" void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
+{
+    if (alignment < alignof(HeapHeader))
+    {
+        alignment = alignof(HeapHeader);
+    }
+    size_t total = size + sizeof(HeapHeader) + alignment;
+    auto *base = static_cast<uint8_t *>(std::malloc(total));
+    if (base == nullptr)
+    {
+        return nullptr;
+    }
+    uintptr_t user = reinterpret_cast<uintptr_t>(base) + sizeof(HeapHeader);
+    user = (user + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    auto *header = reinterpret_cast<HeapHeader *>(user) - 1;
+    header->size = size;
+    header->caps = caps;
+    header->base = base;
+    UsedCounter(caps) += size;
+    return reinterpret_cast<void *>(user);
+}
+
+extern "C" void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return heap_caps_aligned_alloc(alignof(std::max_align_t), size, caps);
+}
+
+extern "C" void *heap_caps_aligned_calloc(size_t alignment, size_t n, size_t size, uint32_t caps)
+{
+    void *ptr = heap_caps_aligned_alloc(alignment, n * size, caps);
+    if (ptr != nullptr)
+    {
+        std::memset(ptr, 0, n * size);
+    }
+    return ptr;
+}
+
+extern "C" void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    return heap_caps_aligned_calloc(alignof(std::max_align_t), n, size, caps);
+}
+
+extern "C" void heap_caps_free(void *ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    auto *header = static_cast<HeapHeader *>(ptr) - 1;
+    UsedCounter(header->caps) -= header->size;
+    std::free(header->base);
+}
+
+extern "C" size_t heap_caps_get_free_size(uint32_t caps)
+{
+    if (caps & MALLOC_CAP_SPIRAM)
+    {
+        return kSimPsramBytes - psram_used;
+    }
+    return kSimInternalBytes - internal_used;
+}
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Build the "font" flash partition from a TTF/OTF font and a character list.
+
+Only the characters that occur in the given text files (plus printable ASCII
+unless --no-ascii) are rendered, at one pixel size, as bpp-bit alpha bitmaps.
+The firmware memory maps the partition and reads glyph records and bitmaps on
+demand, so the font costs neither app partition space nor RAM. Needs Pillow.
+
+    python tools/build_font.py NotoSansSC-Regular.otf --size 16 --chars strings.txt -o font.bin
+    idf.py flash            # font.bin in the project root is flashed too
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x31544E46  # "FNT1"
+VERSION = 1
+HEADER = "<IHBBhhbBHIII"
+RECORD = "<IIHBBbbH"
+PARTITION_SIZE = 0x200000  # partitions.csv
+
+
+def collect_chars(paths, ascii_range):
+    chars = set(chr(c) for c in range(0x20, 0x7F)) if ascii_range else set()
+    for path in paths:
+        with open(path, encoding="utf-8") as f:
+            chars.update(ch for ch in f.read() if ch.isprintable())
+    return sorted(chars, key=ord)
+
+
+def pack_bitmap(mask, width, height, bpp):
+    out = bytearray()
+    shift = 8 - bpp
+    for y in range(height):
+        row = bytearray((width * bpp + 7) // 8)
+        for x in range(width):
+            value = mask[y * width + x] >> shift
+            bit = x * bpp
+            row[bit >> 3] |= value << (8 - bpp - (bit & 7))
+        out += row
+    return bytes(out)
+
+
+def render(font, ch, ascent, bpp):
+    from PIL import Image, ImageDraw
+    advance = int(round(font.getlength(ch)))
+    x0, y0, x1, y1 = font.getbbox(ch)  # relative to the left of the ascender line
+    width, height = max(0, x1 - x0), max(0, y1 - y0)
+    if width == 0 or height == 0:
+        return advance, 0, 0, 0, 0, b""
+    if width > 255 or height > 255:
+        raise ValueError("glyph %r is larger than 255 px" % ch)
+    image = Image.new("L", (width, height), 0)
+    ImageDraw.Draw(image).text((-x0, -y0), ch, font=font, fill=255)
+    # LVGL measures ofs_y from the baseline up to the bottom of the box
+    return advance, width, height, x0, ascent - y1, pack_bitmap(list(image.getdata()), width, height, bpp)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("font", help="TTF or OTF file")
+    parser.add_argument("--size", type=int, default=16, help="pixel size")
+    parser.add_argument("--bpp", type=int, choices=[1, 2, 4, 8], default=4)
+    parser.add_argument("--chars", nargs="*", default=[], help="UTF-8 text files with every character to include")
+    parser.add_argument("--no-ascii", dest="ascii", action="store_false", help="leave out printable ASCII")
+    parser.add_argument("-o", "--output", default="font.bin")
+    args = parser.parse_args()
+
+    from PIL import ImageFont
+    font = ImageFont.truetype(args.font, args.size)
+    ascent, descent = font.getmetrics()
+
+    chars = collect_chars(args.chars, args.ascii)
+    records = []
+    bitmaps = bytearray()
+    for ch in chars:
+        advance, width, height, ofs_x, ofs_y, bitmap = render(font, ch, ascent, args.bpp)
+        records.append(struct.pack(RECORD, ord(ch), len(bitmaps), advance, width, height, ofs_x, ofs_y, 0))
+        bitmaps += bitmap
+
+    bitmap_offset = struct.calcsize(HEADER) + len(records) * struct.calcsize(RECORD)
+    total_size = bitmap_offset + len(bitmaps)
+    underline_position = -max(1, descent // 2)
+    header = struct.pack(HEADER, MAGIC, VERSION, args.bpp, 0, ascent + descent, descent,
+                         underline_position, 1, 0, len(records), bitmap_offset, total_size)
+    blob = header + b"".join(records) + bytes(bitmaps)
+
+    if len(blob) > PARTITION_SIZE:
+        sys.exit("font is %d bytes, the partition holds %d" % (len(blob), PARTITION_SIZE))
+    with open(args.output, "wb") as f:
+        f.write(blob)
+    print("%s: %d glyphs, %d px, %d bpp, %d bytes" % (args.output, len(records), args.size, args.bpp, len(blob)))
+
+
+if __name__ == "__main__":
+    main()
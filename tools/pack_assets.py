@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Pack UI images for the "assets" flash partition.
+
+Each image becomes one entry named after its file (without extension). Images
+with an alpha channel are stored as ARGB8565 (RGB565 + alpha byte), others as
+RGB565, both in LVGL orientation. An image is run-length encoded only when that
+makes it smaller; raw images are drawn straight from the mapped partition, RLE
+images are decoded into PSRAM on first use. Binary PPM (P6) is read directly,
+other formats need Pillow.
+
+    python tools/pack_assets.py icons/*.png -o assets.bin
+    idf.py flash            # assets.bin in the project root is flashed too
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = 0x31545341  # "AST1"
+VERSION = 1
+FORMAT_RGB565 = 0
+FORMAT_ARGB8565 = 1
+ENCODING_RAW = 0
+ENCODING_RLE = 1
+NAME_SIZE = 24
+HEADER = "<IHHII"
+ENTRY = "<%dsHHBBHII" % NAME_SIZE
+PARTITION_SIZE = 0x200000  # partitions.csv
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def read_ppm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(data[pos:end])
+        pos = end
+    if fields[0] != b"P6" or int(fields[3]) != 255:
+        raise ValueError("only 8-bit binary PPM (P6) is supported without Pillow")
+    width, height = int(fields[1]), int(fields[2])
+    pixels = data[pos + 1:pos + 1 + width * height * 3]
+    return width, height, [tuple(pixels[i:i + 3]) + (255,) for i in range(0, len(pixels), 3)], False
+
+
+def read_image(path):
+    if path.lower().endswith((".ppm", ".pnm")):
+        return read_ppm(path)
+    from PIL import Image
+    image = Image.open(path)
+    has_alpha = image.mode in ("RGBA", "LA") or (image.mode == "P" and "transparency" in image.info)
+    image = image.convert("RGBA")
+    return image.width, image.height, list(image.getdata()), has_alpha
+
+
+def encode_pixels(pixels, image_format):
+    out = []
+    for r, g, b, a in pixels:
+        color = struct.pack("<H", rgb565(r, g, b))
+        out.append(color + bytes([a]) if image_format == FORMAT_ARGB8565 else color)
+    return out
+
+
+def rle(pixels):
+    out = bytearray()
+    i = 0
+    while i < len(pixels):
+        j = i
+        while j < len(pixels) and pixels[j] == pixels[i] and j - i < 0xFFFF:
+            j += 1
+        out += struct.pack("<H", j - i) + pixels[i]
+        i = j
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("images", nargs="+", help="images in LVGL orientation")
+    parser.add_argument("-o", "--output", default="assets.bin")
+    parser.add_argument("--format", choices=["auto", "rgb565", "argb8565"], default="auto",
+                        help="auto picks argb8565 for images with an alpha channel")
+    parser.add_argument("--no-rle", dest="rle", action="store_false", help="store every image raw (zero copy)")
+    args = parser.parse_args()
+
+    entries = []
+    for path in args.images:
+        name = os.path.splitext(os.path.basename(path))[0]
+        if len(name.encode()) >= NAME_SIZE:
+            sys.exit("%s: name longer than %d bytes" % (name, NAME_SIZE - 1))
+        width, height, pixels, has_alpha = read_image(path)
+        if args.format == "auto":
+            image_format = FORMAT_ARGB8565 if has_alpha else FORMAT_RGB565
+        else:
+            image_format = FORMAT_ARGB8565 if args.format == "argb8565" else FORMAT_RGB565
+        encoded = encode_pixels(pixels, image_format)
+        raw = b"".join(encoded)
+        packed = rle(encoded) if args.rle else raw
+        encoding = ENCODING_RLE if len(packed) < len(raw) else ENCODING_RAW
+        entries.append((name, width, height, image_format, encoding, packed if encoding == ENCODING_RLE else raw))
+
+    table_end = struct.calcsize(HEADER) + len(entries) * struct.calcsize(ENTRY)
+    offset = table_end
+    table = b""
+    data = b""
+    for name, width, height, image_format, encoding, payload in entries:
+        padding = (-offset) % 4
+        data += b"\0" * padding
+        offset += padding
+        table += struct.pack(ENTRY, name.encode(), width, height, image_format, encoding, 0, offset, len(payload))
+        data += payload
+        offset += len(payload)
+        print("  %-23s %4dx%-4d %-8s %-3s %7d bytes" % (name, width, height,
+                                                     "argb8565" if image_format == FORMAT_ARGB8565 else "rgb565",
+                                                     "rle" if encoding == ENCODING_RLE else "raw", len(payload)))
+    blob = struct.pack(HEADER, MAGIC, VERSION, len(entries), offset, 0) + table + data
+
+    if len(blob) > PARTITION_SIZE:
+        sys.exit("image pack is %d bytes, the partition holds %d" % (len(blob), PARTITION_SIZE))
+    with open(args.output, "wb") as f:
+        f.write(blob)
+    print("%s: %d images, %d bytes" % (args.output, len(entries), len(blob)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""Pack a boot splash image for the "splash" flash partition.
+
+The image is given in the orientation LVGL draws in (960x376 with the default
+DISPLAY_SWAP_XY) and is rotated here into panel scan order, so the firmware only
+has to copy or run-length decode it into the frame buffer. Binary PPM (P6) is
+read directly, other formats need Pillow. Without --image a plain branded frame
+is generated.
+
+    python tools/pack_splash.py --image logo.png -o splash.bin
+    idf.py flash            # splash.bin in the project root is flashed too
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x314C5053  # "SPL1"
+ENCODING_RAW = 0
+ENCODING_RLE = 1
+PARTITION_SIZE = 0xB1000  # partitions.csv, one raw 376x960 frame and the header
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def read_ppm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(data[pos:end])
+        pos = end
+    if fields[0] != b"P6" or int(fields[3]) != 255:
+        raise ValueError("only 8-bit binary PPM (P6) is supported without Pillow")
+    width, height = int(fields[1]), int(fields[2])
+    pixels = data[pos + 1:pos + 1 + width * height * 3]
+    return width, height, [tuple(pixels[i:i + 3]) for i in range(0, len(pixels), 3)]
+
+
+def read_image(path):
+    if path.lower().endswith((".ppm", ".pnm")):
+        return read_ppm(path)
+    from PIL import Image
+    image = Image.open(path).convert("RGB")
+    return image.width, image.height, list(image.getdata())
+
+
+def default_splash(width, height):
+    # Dark background with a centred accent bar in the UI's blue
+    background, accent = (0x00, 0x10, 0x20), (0x00, 0x80, 0xFF)
+    bar_w, bar_h = width // 3, max(height // 24, 4)
+    x0, y0 = (width - bar_w) // 2, (height - bar_h) // 2
+    return [accent if x0 <= x < x0 + bar_w and y0 <= y < y0 + bar_h else background
+            for y in range(height) for x in range(width)]
+
+
+def to_panel_order(pixels, width, height, swap_xy, mirror_x, mirror_y):
+    """Same mapping as esp_lcd: swap the axes, then mirror in panel space."""
+    panel_w, panel_h = (height, width) if swap_xy else (width, height)
+    out = [0] * (panel_w * panel_h)
+    for y in range(height):
+        for x in range(width):
+            px, py = (y, x) if swap_xy else (x, y)
+            if mirror_x:
+                px = panel_w - 1 - px
+            if mirror_y:
+                py = panel_h - 1 - py
+            out[py * panel_w + px] = rgb565(*pixels[y * width + x])
+    return panel_w, panel_h, out
+
+
+def rle(values):
+    runs = []
+    i = 0
+    while i < len(values):
+        j = i
+        while j < len(values) and values[j] == values[i] and j - i < 0xFFFF:
+            j += 1
+        runs += [j - i, values[i]]
+        i = j
+    return runs
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--image", help="splash image in LVGL orientation")
+    parser.add_argument("-o", "--output", default="splash.bin")
+    parser.add_argument("--width", type=int, default=960, help="LVGL width for the generated splash")
+    parser.add_argument("--height", type=int, default=376, help="LVGL height for the generated splash")
+    parser.add_argument("--no-swap-xy", dest="swap_xy", action="store_false")
+    parser.add_argument("--no-mirror-x", dest="mirror_x", action="store_false")
+    parser.add_argument("--mirror-y", action="store_true")
+    args = parser.parse_args()
+
+    if args.image:
+        width, height, pixels = read_image(args.image)
+    else:
+        width, height, pixels = args.width, args.height, default_splash(args.width, args.height)
+
+    panel_w, panel_h, values = to_panel_order(pixels, width, height, args.swap_xy, args.mirror_x, args.mirror_y)
+    runs = rle(values)
+    if len(runs) < len(values):
+        encoding, words = ENCODING_RLE, runs
+    else:
+        encoding, words = ENCODING_RAW, values
+    payload = struct.pack("<%dH" % len(words), *words)
+    blob = struct.pack("<IHHHHI", MAGIC, panel_w, panel_h, encoding, 0, len(payload)) + payload
+
+    if len(blob) > PARTITION_SIZE:
+        sys.exit("splash is %d bytes, the partition holds %d" % (len(blob), PARTITION_SIZE))
+    with open(args.output, "wb") as f:
+        f.write(blob)
+    print("%s: %dx%d panel frame, %s, %d bytes" % (args.output, panel_w, panel_h,
+                                                  "rle" if encoding == ENCODING_RLE else "raw", len(blob)))
+
+
+if __name__ == "__main__":
+    main()